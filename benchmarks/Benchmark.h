@@ -0,0 +1,347 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Benchmark_H
+
+#define Benchmark_H
+/* --- Includes -- */
+#include "Timer.h"                                  // for PhaseTimings
+
+/* -- STL -- */
+#include <algorithm>                                // for sort, min_element
+#include <chrono>                                   // for steady_clock
+#include <cmath>                                    // for isfinite
+#include <cstdlib>                                  // for atoi, atof
+#include <ctime>                                    // for time, strftime
+#include <exception>                                // for exception
+#include <fstream>                                  // for ifstream, ofstream
+#include <functional>                               // for function
+#include <iomanip>                                  // for setprecision
+#include <iostream>                                 // for cout
+#include <map>                                      // for map
+#include <sstream>                                  // for stringstream
+#include <string>                                   // for string
+#include <thread>                                   // for hardware_concurrency
+#include <vector>                                   // for vector
+
+/* -- POSIX -- */
+#include <sys/resource.h>                           // for getrusage
+
+/**
+ * @brief Returns the peak resident set size of the process since the last reset_peak_rss().
+ *
+ * Reads VmHWM from /proc/self/status, and falls back to getrusage where /proc is not available.
+ * @returns the peak resident set size in bytes.
+ */
+inline std::size_t peak_rss()
+{
+   std::ifstream status("/proc/self/status");
+   std::string line;
+   while( std::getline(status, line) )
+      if( line.compare(0, 6, "VmHWM:")==0 )
+        return std::stoull(line.substr(6))*1024;
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+   return usage.ru_maxrss;
+#else
+   return usage.ru_maxrss*1024;
+#endif
+}
+
+/**
+ * @brief Resets the peak resident set size to the current resident set size,
+ *        so that peak_rss() measures a single benchmark case. Only supported on Linux.
+ */
+inline void reset_peak_rss()
+{
+   std::ofstream clear_refs("/proc/self/clear_refs");
+   if( clear_refs.is_open() )
+     clear_refs << "5";
+}
+
+/**
+ * \class Stopwatch
+ * Accumulates the timed sections of a benchmark case, so that the setup of a case is not timed.
+ */
+class Stopwatch
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    void start()
+    {
+       begin = Clock::now();
+    }
+
+    void stop()
+    {
+       seconds += std::chrono::duration<double>(Clock::now()-begin).count();
+    }
+
+    double elapsed() const
+    {
+       return seconds;
+    }
+
+  private:
+    Clock::time_point begin;
+    double seconds = 0;
+};
+
+/**
+ * \class BenchmarkReport
+ *
+ * Runs benchmark cases and writes the results as JSON.
+ *
+ * Each case is repeated, and the minimum and median wall time of the timed sections are
+ * reported together with the peak resident set size and the metrics returned by the case,
+ * e.g. the number of cells and the mesh quality. The SVMTK phase timings of the last
+ * repetition are included when enabled.
+ *
+ * A case that throws is reported with the error message, and does not stop the other cases.
+ */
+class BenchmarkReport
+{
+  public:
+    typedef std::map<std::string,double> Metrics;
+    typedef std::map<std::string,std::string> Parameters;
+    typedef std::function<Metrics(Stopwatch&)> Case;
+
+    /**
+     * @brief Constructs a report from the command line arguments.
+     *
+     * Recognized arguments are --output file, --repetitions n, --warmup n (untimed repetitions
+     * before the timed ones), --filter substring,
+     * --phases (records the SVMTK phase timings), and any --key value pair, which can
+     * be read with get_option.
+     * @param suite the name of the benchmark suite.
+     * @param argc number of arguments.
+     * @param argv the arguments.
+     */
+    BenchmarkReport(std::string suite, int argc, char** argv) : suite(suite), output(suite + ".json")
+    {
+       for(int i = 1; i < argc; ++i)
+       {
+          std::string key = argv[i];
+          if( key.compare(0, 2, "--")!=0 )
+            continue;
+          key = key.substr(2);
+          if( key=="phases" )
+            options[key] = "1";
+          else if( i+1 < argc )
+            options[key] = argv[++i];
+       }
+       if( options.count("output") )
+         output = options["output"];
+       if( options.count("repetitions") )
+         repetitions = std::max(1, std::atoi(options["repetitions"].c_str()));
+       if( options.count("warmup") )
+         warmup = std::max(0, std::atoi(options["warmup"].c_str()));
+       if( options.count("filter") )
+         filter = options["filter"];
+       PhaseTimings::instance().enable(options.count("phases")>0);
+    }
+
+    /**
+     * @brief Returns a command line option.
+     * @param key the option without the leading --.
+     * @param default_value the value if the option is not given.
+     * @returns the value of the option.
+     */
+    std::string get_option(std::string key, std::string default_value) const
+    {
+       auto it = options.find(key);
+       return it==options.end() ? default_value : it->second;
+    }
+
+    /**
+     * @brief Returns a command line option with a comma separated list of numbers.
+     * @param key the option without the leading --.
+     * @param default_value the value if the option is not given.
+     * @returns the numbers.
+     */
+    std::vector<double> get_list_option(std::string key, std::string default_value) const
+    {
+       std::vector<double> values;
+       std::stringstream stream(get_option(key, default_value));
+       std::string item;
+       while( std::getline(stream, item, ',') )
+          if( !item.empty() )
+            values.push_back(std::atof(item.c_str()));
+       return values;
+    }
+
+    /**
+     * @brief Runs a benchmark case, unless the name does not contain the filter.
+     * @param name the name of the case.
+     * @param parameters the parameters of the case, e.g. model, resolution and threads.
+     * @param function the case, which times its sections with the Stopwatch and returns its metrics.
+     * @returns the median wall time, or a negative value if the case is filtered or fails.
+     */
+    double run(std::string name, Parameters parameters, Case function)
+    {
+       if( !filter.empty() and name.find(filter)==std::string::npos )
+         return -1;
+       std::cout << name;
+       for(auto const& parameter : parameters)
+          std::cout << " " << parameter.first << "=" << parameter.second;
+       std::cout << std::flush;
+
+       Result result;
+       result.name = name;
+       result.parameters = parameters;
+       std::vector<double> seconds;
+       try
+       {
+          for(int i = 0; i < warmup; ++i)
+          {
+             Stopwatch stopwatch;
+             function(stopwatch);
+          }
+          for(int i = 0; i < repetitions; ++i)
+          {
+             PhaseTimings::instance().clear();
+             reset_peak_rss();
+             Stopwatch stopwatch;
+             result.metrics = function(stopwatch);
+             seconds.push_back(stopwatch.elapsed());
+             result.peak_rss = std::max(result.peak_rss, peak_rss());
+          }
+          result.phases = PhaseTimings::instance().get_timings();
+       }
+       catch(const std::exception& e)
+       {
+          result.error = e.what();
+       }
+       if( !seconds.empty() )
+       {
+         std::sort(seconds.begin(), seconds.end());
+         result.min_seconds = seconds.front();
+         result.median_seconds = seconds[seconds.size()/2];
+       }
+       result.repetitions = seconds.size();
+       results.push_back(result);
+
+       if( result.error.empty() )
+         std::cout << ": " << result.median_seconds << " s, " << result.peak_rss/(1024*1024) << " MiB" << std::endl;
+       else
+         std::cout << ": failed, " << result.error << std::endl;
+       return result.error.empty() ? result.median_seconds : -1;
+    }
+
+    /**
+     * @brief Writes the results to the output file as JSON.
+     * @throws InvalidArgumentError if the file can not be opened.
+     */
+    void write() const
+    {
+       std::ofstream out(output);
+       if( !out.is_open() )
+         throw InvalidArgumentError("Can't open file.");
+       char date[32];
+       std::time_t now = std::time(nullptr);
+       std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+       out << std::setprecision(9);
+       out << "{\n\"suite\": " << quote(suite)
+           << ",\n\"date\": " << quote(date)
+           << ",\n\"hardware_threads\": " << std::thread::hardware_concurrency()
+           << ",\n\"repetitions\": " << repetitions
+           << ",\n\"warmup\": " << warmup
+           << ",\n\"results\": [";
+       for(std::size_t i = 0; i < results.size(); ++i)
+       {
+          const Result& result = results[i];
+          out << (i>0 ? ",\n" : "\n") << "{\"name\": " << quote(result.name) << ", \"parameters\": {";
+          write_map(out, result.parameters);
+          out << "}, \"repetitions\": " << result.repetitions
+              << ", \"min_seconds\": " << result.min_seconds
+              << ", \"median_seconds\": " << result.median_seconds
+              << ", \"peak_rss\": " << result.peak_rss
+              << ", \"metrics\": {";
+          write_map(out, result.metrics);
+          out << "}";
+          if( !result.phases.empty() )
+          {
+            out << ", \"phases\": {";
+            write_map(out, result.phases);
+            out << "}";
+          }
+          if( !result.error.empty() )
+            out << ", \"error\": " << quote(result.error);
+          out << "}";
+       }
+       out << "\n]\n}\n";
+       std::cout << "Results written to " << output << std::endl;
+    }
+
+  private:
+    struct Result
+    {
+       std::string name;
+       Parameters parameters;
+       Metrics metrics;
+       Metrics phases;
+       std::size_t repetitions = 0;
+       double min_seconds = 0;
+       double median_seconds = 0;
+       std::size_t peak_rss = 0;
+       std::string error;
+    };
+
+    static std::string quote(const std::string& text)
+    {
+       std::string result = "\"";
+       for(char c : text)
+       {
+          if( c=='"' or c=='\\' )
+            result += '\\';
+          if( c=='\n' )
+          {
+            result += "\\n";
+            continue;
+          }
+          result += c;
+       }
+       return result + "\"";
+    }
+
+    static void write_value(std::ostream& out, const std::string& value) { out << quote(value); }
+    static void write_value(std::ostream& out, double value) { if( std::isfinite(value) ) out << value; else out << "null"; }
+
+    template<typename Map>
+    static void write_map(std::ostream& out, const Map& map)
+    {
+       bool first = true;
+       for(auto const& item : map)
+       {
+          out << (first ? "" : ", ") << quote(item.first) << ": ";
+          write_value(out, item.second);
+          first = false;
+       }
+    }
+
+    std::string suite;
+    std::string output;
+    std::string filter;
+    int repetitions = 3;
+    int warmup = 0;
+    std::map<std::string,std::string> options;
+    std::vector<Result> results;
+};
+
+#endif
@@ -0,0 +1,253 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * Benchmarks of Domain construction, meshing, optimization, subdomain removal and output
+ * for the models in examples/Data and the synthetic scenes of make_workload, and the thread
+ * scaling of BatchMesher and Domain::create_mesh_sweep.
+ *
+ * Usage: SVMTK_benchmark_Domain [--data examples/Data] [--output Domain.json]
+ *                               [--resolution 16] [--threads 1,2,4,8] [--repetitions 3]
+ *                               [--surfaces 4] [--triangles 20000] [--seed 0]
+ *                               [--filter name] [--phases]
+ */
+#include "Benchmark.h"
+#include "Surface.h"
+#include "Domain.h"
+#include "Batch.h"
+#include "SubdomainMap.h"
+#include "Workload.h"
+
+#include <cstdio>                                   // for remove
+
+/**
+ * @brief Returns the metrics of a meshed Domain, i.e. the number of cells and the mesh quality.
+ * @param domain the meshed Domain.
+ * @returns the metrics.
+ */
+BenchmarkReport::Metrics mesh_metrics(Domain& domain)
+{
+   BenchmarkReport::Metrics metrics;
+   metrics["cells"] = domain.number_of_cells();
+   metrics["vertices"] = domain.number_of_vertices();
+   if( domain.number_of_cells()==0 )
+     return metrics;
+   auto angles = domain.dihedral_angles_min_max();
+   auto ratios = domain.radius_ratios_min_max();
+   metrics["min_dihedral_angle"] = angles.first;
+   metrics["max_dihedral_angle"] = angles.second;
+   metrics["min_radius_ratio"] = ratios.first;
+   return metrics;
+}
+
+/**
+ * \struct Scene
+ * The input surfaces of a benchmark, with an optional subdomain map.
+ */
+struct Scene
+{
+   std::string name;
+   std::vector<Surface> surfaces;
+   std::shared_ptr<AbstractMap> map;
+
+   std::unique_ptr<Domain> make_domain() const
+   {
+      if( map )
+        return std::unique_ptr<Domain>(new Domain(surfaces, map));
+      return std::unique_ptr<Domain>(new Domain(surfaces));
+   }
+
+   int faces() const
+   {
+      int result = 0;
+      for(auto const& surface : surfaces)
+         result += surface.num_faces();
+      return result;
+   }
+};
+
+/**
+ * @brief Runs the sequential benchmarks of a scene.
+ * @param report the benchmark report.
+ * @param scene the scene.
+ * @param resolution the mesh resolution.
+ */
+void benchmark_scene(BenchmarkReport& report, const Scene& scene, double resolution)
+{
+   BenchmarkReport::Parameters parameters{{"model", scene.name}, {"resolution", std::to_string(resolution)},
+                                          {"faces", std::to_string(scene.faces())}};
+
+   report.run("Domain::Domain", parameters, [&](Stopwatch& stopwatch)
+   {
+      stopwatch.start();
+      auto domain = scene.make_domain();
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"bounding_sphere_radius", domain->get_bounding_sphere_radius()}};
+   });
+
+   report.run("Domain::create_mesh", parameters, [&](Stopwatch& stopwatch)
+   {
+      auto domain = scene.make_domain();
+      stopwatch.start();
+      domain->create_mesh(resolution);
+      stopwatch.stop();
+      auto metrics = mesh_metrics(*domain);
+      metrics["memory"] = domain->memory_report()["total"];
+      return metrics;
+   });
+
+   for(std::string optimizer : {"lloyd", "odt", "exude", "perturb"})
+      report.run("Domain::" + optimizer, parameters, [&](Stopwatch& stopwatch)
+      {
+         auto domain = scene.make_domain();
+         domain->create_mesh(resolution);
+         stopwatch.start();
+         if( optimizer=="lloyd" )
+           domain->lloyd(0, 0, 0.02, 0.01, true);
+         else if( optimizer=="odt" )
+           domain->odt(0, 0, 0.02, 0.01, true);
+         else if( optimizer=="exude" )
+           domain->exude();
+         else
+           domain->perturb();
+         stopwatch.stop();
+         return mesh_metrics(*domain);
+      });
+
+   if( scene.surfaces.size()>1 )
+     report.run("Domain::remove_subdomain", parameters, [&](Stopwatch& stopwatch)
+     {
+        auto domain = scene.make_domain();
+        domain->create_mesh(resolution);
+        int tag = *domain->get_subdomains().begin();
+        stopwatch.start();
+        domain->remove_subdomain(tag);
+        stopwatch.stop();
+        return mesh_metrics(*domain);
+     });
+
+   report.run("Domain::save", parameters, [&](Stopwatch& stopwatch)
+   {
+      auto domain = scene.make_domain();
+      domain->create_mesh(resolution);
+      std::string filename = "benchmark_" + scene.name + ".mesh";
+      stopwatch.start();
+      domain->save(filename, true);
+      stopwatch.stop();
+      std::ifstream file(filename, std::ios::binary | std::ios::ate);
+      BenchmarkReport::Metrics metrics{{"bytes", static_cast<double>(file.tellg())}};
+      file.close();
+      std::remove(filename.c_str());
+      return metrics;
+   });
+}
+
+/**
+ * @brief Runs the thread scaling benchmarks for each thread count.
+ * @param report the benchmark report.
+ * @param scenes the scenes meshed concurrently by BatchMesher.
+ * @param threads the thread counts.
+ * @param resolution the mesh resolution.
+ */
+void benchmark_scaling(BenchmarkReport& report, const std::vector<Scene>& scenes, const std::vector<double>& threads, double resolution)
+{
+   for(double num_threads : threads)
+   {
+      BenchmarkReport::Parameters parameters{{"threads", std::to_string(static_cast<int>(num_threads))},
+                                             {"jobs", std::to_string(scenes.size())},
+                                             {"resolution", std::to_string(resolution)}};
+      report.run("BatchMesher::run", parameters, [&](Stopwatch& stopwatch)
+      {
+         std::vector<MeshingJob<Surface>> jobs;
+         for(auto const& scene : scenes)
+         {
+            MeshingJob<Surface> job;
+            job.surfaces = scene.surfaces;
+            job.map = scene.map;
+            job.mesh_resolution = resolution;
+            jobs.push_back(job);
+         }
+         BatchMesher<Surface> batch(static_cast<int>(num_threads));
+         stopwatch.start();
+         auto results = batch.run(jobs);
+         stopwatch.stop();
+         BenchmarkReport::Metrics metrics{{"cells", 0}, {"completed", 0}};
+         for(auto const& result : results)
+         {
+            metrics["cells"] += result.number_of_cells;
+            metrics["completed"] += result.completed;
+         }
+         return metrics;
+      });
+   }
+
+   const Scene& scene = scenes.front();
+   std::vector<double> resolutions{resolution/2, resolution*3/4, resolution, resolution*5/4};
+   for(double num_threads : threads)
+   {
+      BenchmarkReport::Parameters parameters{{"model", scene.name},
+                                             {"threads", std::to_string(static_cast<int>(num_threads))},
+                                             {"resolutions", std::to_string(resolutions.size())}};
+      report.run("Domain::create_mesh_sweep", parameters, [&](Stopwatch& stopwatch)
+      {
+         auto domain = scene.make_domain();
+         stopwatch.start();
+         auto meshes = domain->create_mesh_sweep(resolutions, static_cast<int>(num_threads));
+         stopwatch.stop();
+         BenchmarkReport::Metrics metrics{{"cells", 0}};
+         for(auto const& mesh : meshes)
+            metrics["cells"] += mesh->number_of_cells();
+         return metrics;
+      });
+   }
+}
+
+int main(int argc, char** argv)
+{
+   BenchmarkReport report("Domain", argc, argv);
+   std::string data = report.get_option("data", "examples/Data");
+   double resolution = std::atof(report.get_option("resolution", "16").c_str());
+   std::vector<double> threads = report.get_list_option("threads", "1,2,4,8");
+
+   std::vector<Scene> scenes;
+   for(std::string model : {"blobby", "elephant", "pig", "eight", "horizons"})
+   {
+      Scene scene;
+      scene.name = model;
+      scene.surfaces.push_back(Surface(data + "/" + model + ".off"));
+      scenes.push_back(scene);
+   }
+   int surfaces = std::atoi(report.get_option("surfaces", "4").c_str());
+   int triangles = std::atoi(report.get_option("triangles", "20000").c_str());
+   unsigned int seed = std::atoi(report.get_option("seed", "0").c_str());
+   for(std::string name : {"nested_shells", "packed_spheres", "touching_blocks", "tubular_network"})
+   {
+      Workload<Surface> workload = make_workload<Surface>(name, surfaces, triangles, seed);
+      Scene scene;
+      scene.name = workload.name;
+      scene.surfaces = workload.surfaces;
+      scene.map = workload.map;
+      scenes.push_back(scene);
+   }
+
+   for(auto const& scene : scenes)
+      benchmark_scene(report, scene, resolution);
+   benchmark_scaling(report, scenes, threads, resolution);
+
+   report.write();
+   return 0;
+}
@@ -0,0 +1,249 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * Micro-benchmarks of the Surface and Slice operations, for spheres and cubes with decreasing
+ * edge length and the models in examples/Data. The input is copied before each repetition,
+ * and only the operation itself is timed.
+ *
+ * Usage: SVMTK_benchmark_Surface [--data examples/Data] [--output Surface.json]
+ *                                [--edge-lengths 0.2,0.1,0.05] [--repetitions 5] [--warmup 1]
+ *                                [--filter name] [--phases]
+ */
+#include "Benchmark.h"
+#include "Surface.h"
+#include "Slice.h"
+
+/**
+ * @brief Returns the size metrics of a surface.
+ * @param surface SVMTK Surface object.
+ * @returns the metrics.
+ */
+BenchmarkReport::Metrics surface_metrics(const Surface& surface)
+{
+   return BenchmarkReport::Metrics{{"vertices", static_cast<double>(surface.num_vertices())},
+                                   {"faces", static_cast<double>(surface.num_faces())}};
+}
+
+/**
+ * \struct Input
+ * A named input surface and the edge length used by the operations.
+ */
+struct Input
+{
+   std::string name;
+   Surface surface;
+   double edge_length;
+
+   BenchmarkReport::Parameters parameters() const
+   {
+      return BenchmarkReport::Parameters{{"model", name}, {"edge_length", std::to_string(edge_length)},
+                                         {"faces", std::to_string(surface.num_faces())}};
+   }
+};
+
+/**
+ * @brief Runs the benchmarks of the operations on a single surface.
+ * @param report the benchmark report.
+ * @param input the input surface.
+ */
+void benchmark_surface(BenchmarkReport& report, const Input& input)
+{
+   auto parameters = input.parameters();
+
+   report.run("Surface::isotropic_remeshing", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      surface.isotropic_remeshing(input.edge_length, 3, false);
+      stopwatch.stop();
+      return surface_metrics(surface);
+   });
+
+   report.run("Surface::smooth_laplacian", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      surface.smooth_laplacian(0.8, 5);
+      stopwatch.stop();
+      return surface_metrics(surface);
+   });
+
+   report.run("Surface::smooth_taubin", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      surface.smooth_taubin(5);
+      stopwatch.stop();
+      return surface_metrics(surface);
+   });
+
+   report.run("Surface::repair_self_intersections", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      auto result = surface.repair_self_intersections();
+      stopwatch.stop();
+      auto metrics = surface_metrics(surface);
+      metrics["repaired"] = result.first;
+      metrics["iterations"] = result.second;
+      return metrics;
+   });
+
+   report.run("Surface::separate_narrow_gaps", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      auto result = surface.separate_narrow_gaps(-0.5, 0.0, 100);
+      stopwatch.stop();
+      auto metrics = surface_metrics(surface);
+      metrics["completed"] = result.first;
+      metrics["iterations"] = result.second;
+      return metrics;
+   });
+
+   report.run("Surface::fill_holes", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      stopwatch.start();
+      int holes = surface.fill_holes();
+      stopwatch.stop();
+      auto metrics = surface_metrics(surface);
+      metrics["holes"] = holes;
+      return metrics;
+   });
+
+   report.run("Surface::get_slice", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      Surface::Point_3 center = surface.centeroid();
+      stopwatch.start();
+      auto slice = surface.get_slice(0, 0, 1, -center.z());
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"constraints", static_cast<double>(slice->number_of_constraints())}};
+   });
+
+   report.run("Slice::create_mesh", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      Surface::Point_3 center = surface.centeroid();
+      auto slice = surface.get_slice(0, 0, 1, -center.z());
+      stopwatch.start();
+      slice->create_mesh(32.);
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"faces", static_cast<double>(slice->number_of_faces())}};
+   });
+
+   report.run("Slice::add_surface_domains", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(input.surface);
+      Surface::Point_3 center = surface.centeroid();
+      auto slice = surface.get_slice(0, 0, 1, -center.z());
+      slice->create_mesh(32.);
+      std::vector<Surface> surfaces{surface};
+      stopwatch.start();
+      slice->add_surface_domains(surfaces);
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"subdomains", static_cast<double>(slice->number_of_subdomains())}};
+   });
+}
+
+/**
+ * @brief Runs the benchmarks of the operations on pairs of surfaces, i.e. two overlapping spheres.
+ * @param report the benchmark report.
+ * @param edge_length the edge length of the spheres.
+ */
+void benchmark_surface_pair(BenchmarkReport& report, double edge_length)
+{
+   Surface first, second;
+   first.make_sphere(0., 0., 0., 1., edge_length);
+   second.make_sphere(0.5, 0., 0., 1., edge_length);
+   BenchmarkReport::Parameters parameters{{"model", "two_spheres"}, {"edge_length", std::to_string(edge_length)},
+                                          {"faces", std::to_string(first.num_faces() + second.num_faces())}};
+
+   for(std::string operation : {"union", "intersection", "difference"})
+      report.run("Surface::surface_" + operation, parameters, [&](Stopwatch& stopwatch)
+      {
+         Surface surface(first);
+         stopwatch.start();
+         bool result;
+         if( operation=="union" )
+           result = surface.surface_union(second);
+         else if( operation=="intersection" )
+           result = surface.surface_intersection(second);
+         else
+           result = surface.surface_difference(second);
+         stopwatch.stop();
+         auto metrics = surface_metrics(surface);
+         metrics["completed"] = result;
+         return metrics;
+      });
+
+   Surface inner;
+   inner.make_sphere(0., 0., 0., 1. - 2*edge_length, edge_length);
+   parameters["model"] = "nested_spheres";
+   parameters["faces"] = std::to_string(first.num_faces() + inner.num_faces());
+   report.run("Surface::get_close_vertices", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(first);
+      stopwatch.start();
+      auto vertices = surface.get_close_vertices(inner);
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"close_vertices", static_cast<double>(vertices.size())}};
+   });
+
+   report.run("Surface::get_close_vertices_with_direction", parameters, [&](Stopwatch& stopwatch)
+   {
+      Surface surface(first);
+      stopwatch.start();
+      auto vertices = surface.get_close_vertices_with_direction(inner, -0.5);
+      stopwatch.stop();
+      return BenchmarkReport::Metrics{{"close_vertices", static_cast<double>(vertices.size())}};
+   });
+}
+
+int main(int argc, char** argv)
+{
+   BenchmarkReport report("Surface", argc, argv);
+   std::string data = report.get_option("data", "examples/Data");
+   std::vector<double> edge_lengths = report.get_list_option("edge-lengths", "0.2,0.1,0.05");
+
+   std::vector<Input> inputs;
+   for(double edge_length : edge_lengths)
+   {
+      Input sphere{"sphere", Surface(), edge_length};
+      sphere.surface.make_sphere(0., 0., 0., 1., edge_length);
+      inputs.push_back(sphere);
+      Input cube{"cube", Surface(), edge_length};
+      cube.surface.make_cube(-1., -1., -1., 1., 1., 1., edge_length);
+      inputs.push_back(cube);
+   }
+   for(std::string model : {"blobby", "elephant", "pig", "mech-holes-shark"})
+   {
+      Input input{model, Surface(data + "/" + model + ".off"), 0};
+      input.edge_length = input.surface.average_edge_length();
+      inputs.push_back(input);
+   }
+
+   for(auto const& input : inputs)
+      benchmark_surface(report, input);
+   for(double edge_length : edge_lengths)
+      benchmark_surface_pair(report, edge_length);
+
+   report.write();
+   return 0;
+}
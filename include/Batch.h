@@ -0,0 +1,269 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Batch_H
+
+#define Batch_H
+/* --- Includes -- */
+#include "Domain.h"
+#include "Errors.h"
+#include "Timer.h"
+#include "Cancellation.h"
+#include "Parallel.h"
+
+/* -- STL -- */
+#include <algorithm>                                // for sort, max
+#include <chrono>                                   // for steady_clock
+#include <condition_variable>                       // for condition_variable
+#include <exception>                                // for exception
+#include <memory>                                   // for shared_ptr
+#include <mutex>                                    // for mutex, unique_lock
+#include <numeric>                                  // for iota
+#include <string>                                   // for string
+#include <vector>                                   // for vector
+
+/**
+ * \struct MeshingJob
+ * A single meshing task for BatchMesher, i.e. the input surfaces, the subdomain map,
+ * the mesh criteria, the post-processing steps and the output path.
+ *
+ * @tparam Surface SVMTK Surface class.
+ */
+template<typename Surface>
+struct MeshingJob
+{
+    std::vector<Surface> surfaces;
+    std::shared_ptr<AbstractMap> map = nullptr;          // nullptr uses the DefaultMap.
+    double mesh_resolution = 0;                          // non-positive uses the surface resolution.
+    double error_bound = 1.e-7;
+    std::vector<std::string> post_processing;            // "lloyd", "odt", "exude" or "perturb", in order.
+    std::string output;                                  // empty skips saving the mesh.
+    bool save_1Dfeatures = true;
+    std::size_t memory_estimate = 0;                     // bytes, zero uses the estimate of BatchMesher.
+};
+
+/**
+ * \struct MeshingResult
+ * The outcome of a MeshingJob.
+ */
+struct MeshingResult
+{
+    bool completed = false;
+    int number_of_cells = 0;
+    double seconds = 0;
+    std::size_t memory = 0;
+    std::string error;
+};
+
+/**
+ * \class BatchMesher
+ * Meshes many independent domains concurrently, one job per worker thread.
+ *
+ * The jobs are started in order of decreasing memory estimate, so that the largest
+ * jobs do not end up last and idle the other workers. A job is only admitted when the
+ * sum of the memory estimates of the running jobs stays below the memory limit,
+ * or when no other job is running.
+ *
+ * The memory estimate of a job is the number of input faces times the largest
+ * number of bytes per input face observed in the completed jobs, unless the job
+ * sets memory_estimate. The meshing inputs of each Domain are released with
+ * Domain::finalize before the post-processing that does not need them.
+ *
+ * Each job runs sequentially, since Domain uses the Sequential_tag, and the jobs
+ * share the CancellationToken that is active on the calling thread.
+ *
+ * @tparam Surface SVMTK Surface class.
+ */
+template<typename Surface>
+class BatchMesher
+{
+  public:
+    // DocString: BatchMesher
+   /**
+    * @brief Constructs a batch mesher.
+    * @param num_threads number of worker threads, non-positive uses the number of hardware threads.
+    * @param memory_limit the admission limit in bytes for the running jobs, zero means no limit.
+    */
+    BatchMesher(int num_threads=0, std::size_t memory_limit=0) : num_threads(num_threads), memory_limit(memory_limit) {}
+
+    // DocString: run
+   /**
+    * @brief Runs all jobs, and returns when every job is completed, failed or cancelled.
+    *
+    * An exception thrown by a job is stored in the error of its result, and does not
+    * stop the other jobs.
+    * @param jobs vector of MeshingJob objects.
+    * @returns a vector of MeshingResult objects in the same order as the jobs.
+    * @throws InvalidArgumentError if a job has an unknown post-processing step.
+    */
+    std::vector<MeshingResult> run(std::vector<MeshingJob<Surface>> jobs)
+    {
+       ScopedTimer timer("BatchMesher::run");
+       for(auto const& job : jobs)
+          for(auto const& step : job.post_processing)
+             if( step!="lloyd" and step!="odt" and step!="exude" and step!="perturb" )
+                throw InvalidArgumentError(("Unknown post-processing step: " + step).c_str());
+
+       std::vector<MeshingResult> results(jobs.size());
+       std::vector<std::size_t> faces(jobs.size(), 0);
+       for(std::size_t i = 0; i < jobs.size(); ++i)
+          for(auto& surface : jobs[i].surfaces)
+             faces[i] += surface.num_faces();
+
+       std::vector<std::size_t> order(jobs.size());
+       std::iota(order.begin(), order.end(), 0);
+       std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+       {
+          return memory_estimate(jobs[a], faces[a]) > memory_estimate(jobs[b], faces[b]);
+       });
+
+       std::size_t next = 0;
+       std::size_t running = 0;
+       std::size_t admitted_memory = 0;
+       std::mutex mutex;
+       std::condition_variable condition;
+
+       auto worker = [&]()
+       {
+          std::unique_lock<std::mutex> lock(mutex);
+          while( next < order.size() )
+          {
+             std::size_t index = order[next];
+             std::size_t estimate = memory_estimate(jobs[index], faces[index]);
+             if( running>0 and memory_limit>0 and admitted_memory + estimate > memory_limit )
+             {
+                condition.wait(lock);
+                continue;
+             }
+             ++next;
+             ++running;
+             admitted_memory += estimate;
+             lock.unlock();
+
+             if( cancellation_requested() )
+               results[index].error = "Cancelled before start.";
+             else
+               results[index] = run_job(jobs[index]);
+
+             lock.lock();
+             if( faces[index]>0 and results[index].memory>0 )
+             {
+               std::size_t observed = results[index].memory/faces[index];
+               bytes_per_face = observed_bytes_per_face ? std::max(bytes_per_face, observed) : observed;
+               observed_bytes_per_face = true;
+             }
+             admitted_memory -= estimate;
+             --running;
+             condition.notify_all();
+          }
+       };
+
+       // Each task is a worker that takes the jobs in order of admission.
+       parallel_for(thread_count(num_threads, jobs.size()), num_threads, [&](std::size_t) { worker(); });
+       return results;
+    }
+
+    // DocString: get_bytes_per_face
+   /**
+    * @brief Returns the number of bytes per input face used to estimate the memory of a job.
+    * @returns the number of bytes per input face.
+    */
+    std::size_t get_bytes_per_face() const
+    {
+       return bytes_per_face;
+    }
+
+  private:
+   /**
+    * @brief Runs a single job.
+    * @param job MeshingJob object.
+    * @returns the outcome of the job.
+    */
+    MeshingResult run_job(MeshingJob<Surface>& job)
+    {
+       ScopedTimer timer("BatchMesher::job");
+       MeshingResult result;
+       auto begin = std::chrono::steady_clock::now();
+       try
+       {
+          std::unique_ptr<Domain> domain;
+          if( job.map )
+            domain.reset(new Domain(job.surfaces, job.map, job.error_bound));
+          else
+            domain.reset(new Domain(job.surfaces, job.error_bound));
+          std::vector<Surface>().swap(job.surfaces);
+          // The jobs run on worker threads, which do not write to stdout.
+          domain->set_verbose(false);
+
+          result.completed = job.mesh_resolution>0 ? domain->create_mesh(job.mesh_resolution) : domain->create_mesh();
+          result.memory = domain->memory_report()["total"];
+
+          bool needs_domain = false;
+          for(auto const& step : job.post_processing)
+             needs_domain = needs_domain or step!="exude";
+          if( !needs_domain )
+            domain->finalize();
+
+          for(auto const& step : job.post_processing)
+          {
+             if( !result.completed )
+               break;
+             if( step=="lloyd" )
+               result.completed = domain->lloyd(0, 0, 0.02, 0.01, true);
+             else if( step=="odt" )
+               result.completed = domain->odt(0, 0, 0.02, 0.01, true);
+             else if( step=="exude" )
+               result.completed = domain->exude();
+             else if( step=="perturb" )
+               result.completed = domain->perturb();
+          }
+          result.number_of_cells = domain->number_of_cells();
+          if( !job.output.empty() and result.number_of_cells>0 )
+            domain->save(job.output, job.save_1Dfeatures);
+       }
+       catch(const std::exception& e)
+       {
+          result.completed = false;
+          result.error = e.what();
+       }
+       catch(...)
+       {
+          // Any exception must be stored, since the worker releases the admitted memory after the job.
+          result.completed = false;
+          result.error = "Unknown error.";
+       }
+       result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-begin).count();
+       return result;
+    }
+
+   /**
+    * @brief Returns the memory estimate of a job.
+    * @param job MeshingJob object.
+    * @param faces the number of input faces of the job.
+    * @returns the memory estimate in bytes.
+    */
+    std::size_t memory_estimate(const MeshingJob<Surface>& job, std::size_t faces) const
+    {
+       return job.memory_estimate>0 ? job.memory_estimate : faces*bytes_per_face;
+    }
+
+    int num_threads;
+    std::size_t memory_limit;
+    std::size_t bytes_per_face = 8192;   // Conservative until the first job is completed.
+    bool observed_bytes_per_face = false;
+};
+
+#endif
@@ -0,0 +1,262 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Cancellation_H
+
+#define Cancellation_H
+/* --- Includes -- */
+
+#include <atomic>                                   // for atomic
+#include <chrono>                                   // for steady_clock
+#include <condition_variable>                       // for condition_variable
+#include <limits>                                   // for numeric_limits
+#include <mutex>                                    // for mutex, unique_lock
+#include <thread>                                   // for thread
+
+/**
+ * \class CancellationToken
+ *
+ * Cooperative cancellation of long running operations in SVMTK, e.g.
+ * Domain::create_mesh, the mesh optimizers and the iterative surface
+ * separation algorithms.
+ *
+ * A token is cancelled either explicitly with cancel(), or when the
+ * wall-clock budget set with set_time_budget() expires. The operations check
+ * the token that is active on the current thread at safe points, and return
+ * with a partial-progress status when the token is cancelled.
+ *
+ * @note The token is activated on the current thread with activate() or
+ *       CancellationScope.
+ */
+class CancellationToken
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    CancellationToken() {}
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /**
+     * @brief Returns the token that is active on the current thread.
+     * @returns a pointer to the active token, or nullptr if no token is active.
+     */
+    static CancellationToken*& current()
+    {
+       static thread_local CancellationToken* token = nullptr;
+       return token;
+    }
+
+    /**
+     * @brief Requests cancellation. Safe to call from a signal handler and other threads.
+     */
+    void cancel()
+    {
+       cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Removes the cancellation request and the time budget.
+     */
+    void reset()
+    {
+       cancelled.store(false, std::memory_order_relaxed);
+       deadline_ns.store(no_deadline, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets a wall-clock budget measured from now.
+     * @param seconds the time budget, a non-positive value removes the budget.
+     */
+    void set_time_budget(double seconds)
+    {
+       if( seconds<=0 )
+       {
+         deadline_ns.store(no_deadline, std::memory_order_relaxed);
+         return;
+       }
+       auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+       deadline_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns true if a time budget is set.
+     * @returns true if a time budget is set.
+     */
+    bool has_time_budget() const
+    {
+       return deadline_ns.load(std::memory_order_relaxed)!=no_deadline;
+    }
+
+    /**
+     * @brief Returns the deadline of the time budget.
+     * @returns the deadline, only valid if has_time_budget() is true.
+     */
+    Clock::time_point deadline() const
+    {
+       return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(deadline_ns.load(std::memory_order_relaxed))));
+    }
+
+    /**
+     * @brief Returns the remaining time of the budget in seconds.
+     * @returns the remaining time, or infinity if no time budget is set.
+     */
+    double remaining_time() const
+    {
+       if( !has_time_budget() )
+         return std::numeric_limits<double>::infinity();
+       double remaining = std::chrono::duration<double>(deadline()-Clock::now()).count();
+       return remaining>0 ? remaining : 0.0;
+    }
+
+    /**
+     * @brief Checks if cancellation is requested or the time budget has expired.
+     * @returns true if the operation should stop.
+     */
+    bool is_cancelled()
+    {
+       if( cancelled.load(std::memory_order_relaxed) )
+         return true;
+       if( has_time_budget() and Clock::now()>=deadline() )
+       {
+         cancel();
+         return true;
+       }
+       return false;
+    }
+
+    /**
+     * @brief Returns the flag that is set on cancellation, for algorithms that poll an atomic boolean.
+     * @note The flag is not set by an expired budget, @see DeadlineWatcher.
+     * @returns pointer to the cancellation flag.
+     */
+    std::atomic<bool>* stop_flag()
+    {
+       return &cancelled;
+    }
+
+    /**
+     * @brief Makes this token the active token of the current thread.
+     *
+     * The token may be active on several threads at the same time, so the previously active 
+     * token is returned to the caller instead of stored in the token.
+     * @returns the token that was active before, to be restored with restore().
+     */
+    CancellationToken* activate()
+    {
+       CancellationToken* previous = current();
+       current() = this;
+       return previous;
+    }
+
+    /**
+     * @brief Makes a token the active token of the current thread, e.g. the token returned by activate().
+     * @param previous the token, or nullptr for no active token.
+     */
+    static void restore(CancellationToken* previous)
+    {
+       current() = previous;
+    }
+
+  private:
+    static constexpr long long no_deadline = std::numeric_limits<long long>::max();
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<long long> deadline_ns{no_deadline};
+};
+
+/**
+ * @brief Checks the token that is active on the current thread.
+ * @returns true if the active token is cancelled, and false if no token is active.
+ */
+inline bool cancellation_requested()
+{
+   CancellationToken* token = CancellationToken::current();
+   return token and token->is_cancelled();
+}
+
+/**
+ * \class CancellationScope
+ *
+ * Activates a token on the current thread for the lifetime of the object,
+ * and restores the previously active token of the thread on destruction.
+ */
+class CancellationScope
+{
+  public:
+    explicit CancellationScope(CancellationToken& token) : previous(token.activate()) {}
+    ~CancellationScope() { CancellationToken::restore(previous); }
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+  private:
+    CancellationToken* previous;
+};
+
+/**
+ * \class DeadlineWatcher
+ *
+ * Sets the stop flag of the active token when its time budget expires.
+ * Used with algorithms that only poll an atomic boolean, such as CGAL Mesh_3.
+ * Does nothing if no token is active, or if the token has no time budget.
+ */
+class DeadlineWatcher
+{
+  public:
+    DeadlineWatcher() : token(CancellationToken::current())
+    {
+       if( !token or !token->has_time_budget() )
+         return;
+       watcher = std::thread([this]()
+       {
+          std::unique_lock<std::mutex> lock(mutex);
+          if( !condition.wait_until(lock, token->deadline(), [this]() { return done; }) )
+            token->cancel();
+       });
+    }
+
+    ~DeadlineWatcher()
+    {
+       if( !watcher.joinable() )
+         return;
+       {
+          std::lock_guard<std::mutex> lock(mutex);
+          done = true;
+       }
+       condition.notify_one();
+       watcher.join();
+    }
+
+    DeadlineWatcher(const DeadlineWatcher&) = delete;
+    DeadlineWatcher& operator=(const DeadlineWatcher&) = delete;
+
+    /**
+     * @brief Returns the stop flag of the active token.
+     * @returns pointer to the stop flag, or nullptr if no token is active.
+     */
+    std::atomic<bool>* stop_flag()
+    {
+       return token ? token->stop_flag() : nullptr;
+    }
+
+  private:
+    CancellationToken* token;
+    std::thread watcher;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool done = false;
+};
+
+#endif
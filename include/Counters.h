@@ -0,0 +1,125 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Counters_H
+
+#define Counters_H
+/* --- Includes -- */
+
+#include <array>                                    // for array
+#include <atomic>                                   // for atomic
+#include <cstddef>                                  // for size_t
+#include <map>                                      // for map
+#include <string>                                   // for string
+
+/**
+ * \class QueryCounters
+ *
+ * Counts the number of spatial queries and spatial search structures
+ * constructed by a SVMTK Domain or Surface object. Used to investigate
+ * whether the runtime is dominated by inside tests, AABB queries or
+ * kd-tree constructions.
+ *
+ * The counters use relaxed atomics, and may be incremented from
+ * several threads.
+ */
+class QueryCounters
+{
+  public:
+    enum Counter
+    {
+      LABELING_CALLS = 0,
+      IS_IN_DOMAIN_EVALUATIONS,
+      SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS,
+      SIDE_OF_TRIANGLE_MESH_QUERIES,
+      AABB_TREE_CONSTRUCTIONS,
+      KD_TREE_CONSTRUCTIONS,
+      NEAREST_NEIGHBOUR_SEARCHES,
+      NUMBER_OF_COUNTERS
+    };
+
+    QueryCounters() { reset(); }
+
+    /**
+     * @brief Copies the current values of the counters.
+     * @param other QueryCounters object.
+     */
+    QueryCounters(const QueryCounters& other)
+    {
+       for(std::size_t i = 0; i < NUMBER_OF_COUNTERS; ++i)
+          counts[i].store(other.counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    QueryCounters& operator=(const QueryCounters& other)
+    {
+       for(std::size_t i = 0; i < NUMBER_OF_COUNTERS; ++i)
+          counts[i].store(other.counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+       return *this;
+    }
+
+    /**
+     * @brief Increments a counter.
+     * @param counter the counter to increment.
+     * @param n the increment.
+     */
+    void increment(Counter counter, std::size_t n=1)
+    {
+       counts[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the value of a counter.
+     * @param counter the counter.
+     * @returns the value of the counter.
+     */
+    std::size_t get(Counter counter) const
+    {
+       return counts[counter].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets all counters to zero.
+     */
+    void reset()
+    {
+       for(auto& count : counts)
+          count.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the value of all counters.
+     * @returns a map with counter names as keys and counts as values.
+     */
+    std::map<std::string,std::size_t> get_counters() const
+    {
+       static const char* names[NUMBER_OF_COUNTERS] = { "labeling_calls",
+                                                        "is_in_domain_evaluations",
+                                                        "side_of_triangle_mesh_constructions",
+                                                        "side_of_triangle_mesh_queries",
+                                                        "aabb_tree_constructions",
+                                                        "kd_tree_constructions",
+                                                        "nearest_neighbour_searches" };
+       std::map<std::string,std::size_t> result;
+       for(std::size_t i = 0; i < NUMBER_OF_COUNTERS; ++i)
+          result[names[i]] = counts[i].load(std::memory_order_relaxed);
+       return result;
+    }
+
+  private:
+    std::array<std::atomic<std::size_t>,NUMBER_OF_COUNTERS> counts;
+};
+
+#endif
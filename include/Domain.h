@@ -20,6 +20,11 @@
 
 /* --- Includes -- */
 #include "Polyhedral_vector_to_labeled_function_wrapper.h"
+#include "Timer.h"
+#include "Counters.h"
+#include "Cancellation.h"
+#include "Parallel.h"
+#include "Graph_partition.h"
 
 /* -- CGAL Bounding Volumes -- */
 #include <CGAL/Min_sphere_of_spheres_d.h>
@@ -38,6 +43,42 @@
 /* -- CGAL Mesh_3 -- */ 
 #include <CGAL/Polygon_mesh_processing/detect_features.h>
 #include <CGAL/Mesh_3/polylines_to_protect.h>
+#include <CGAL/Polygon_mesh_processing/polygon_mesh_to_polygon_soup.h>
+#include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h>
+#include <CGAL/Polygon_mesh_processing/intersection.h>
+#include <CGAL/Surface_mesh.h>
+
+/* -- CGAL Intersections -- */
+#include <CGAL/box_intersection_d.h>
+#include <CGAL/intersections.h>
+
+/* -- CGAL AABB -- */
+#include <CGAL/AABB_tree.h>
+#include <CGAL/AABB_traits.h>
+#include <CGAL/AABB_triangle_primitive.h>
+#include <CGAL/AABB_segment_primitive.h>
+
+/* -- CGAL Spatial Sorting -- */
+#include <CGAL/hilbert_sort.h>
+#include <CGAL/Spatial_sort_traits_adapter_3.h>
+#include <CGAL/property_map.h>
+
+/* -- Eigen -- */
+#include <Eigen/Sparse>
+
+/* -- STL -- */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
 
 /**
  * @brief Transform facets with a specific tag to points and facet connections.
@@ -128,6 +169,8 @@ void facets_in_complex_3_to_triangle_soup_(const C3T3& c3t3,
  *  @param facet_twice_pmap 
  *  @param print_each_facet_twice
  *  @param save_edges 
+ *  @param vertex_order the vertices in the order that they are written, empty uses the triangulation order.
+ *  @param cell_order the cells in the order that they are written, empty uses the complex order.
 */
 template <class C3T3,
           class Vertex_index_property_map,
@@ -141,7 +184,9 @@ void output_to_medit_(std::ostream& os,
                 const Cell_index_property_map& cell_pmap,
                 const Facet_index_property_map_twice& facet_twice_pmap = Facet_index_property_map_twice(),
                 const bool print_each_facet_twice = false,
-                const bool save_edges = true )
+                const bool save_edges = true,
+                const std::vector<typename C3T3::Vertex_handle>& vertex_order = {},
+                const std::vector<typename C3T3::Cell_handle>& cell_order = {} )
 {
   typedef typename C3T3::Triangulation Tr;
   typedef typename C3T3::Cells_in_complex_iterator Cell_iterator;
@@ -160,9 +205,14 @@ void output_to_medit_(std::ostream& os,
 
   os << "Vertices\n" << tr.number_of_vertices() << '\n';
 
+  std::vector<Vertex_handle> vertices(vertex_order);
+  if( vertices.empty() )
+    for( Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit )
+       vertices.push_back(vit);
+
   boost::unordered_map<Vertex_handle, int> V;
   int inum = 1;
-  for( Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit )
+  for( Vertex_handle vit : vertices )
   {
     V[vit] = inum++;
     Weighted_point p = tr.point(vit);
@@ -254,7 +304,12 @@ void output_to_medit_(std::ostream& os,
   os << "Tetrahedra\n"
      << c3t3.number_of_cells_in_complex() << '\n';
 
-  for( Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end();++cit )
+  std::vector<typename C3T3::Cell_handle> cells(cell_order);
+  if( cells.empty() )
+    for( Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end();++cit )
+       cells.push_back(cit);
+
+  for( auto cit : cells )
   {
     for (int i=0; i<4; i++)
       os << V[cit->vertex(i)] << ' ';
@@ -298,11 +353,60 @@ struct Minimum_sphere
                Min_sphere ms(S.begin(), S.end());
                return CGAL::to_double(ms.radius());
            }
+
+           /**
+            * @brief Returns the number of bytes allocated for the added surface points.
+            * @returns the number of bytes allocated for the added surface points.
+            */
+           std::size_t memory_usage() const
+           {
+               return S.capacity()*sizeof(Sphere);
+           }
+
+           /**
+            * @brief Removes the added surface points and releases their memory.
+            */
+           void clear()
+           {
+               std::vector<Sphere>().swap(S);
+           }
            private:
                  std::vector<Sphere> S;
 };
 
 
+// DocString: OptimizationPass
+/**
+ * \struct OptimizationPass
+ * A mesh optimizer run by Domain::optimize, with the mesh quality before and after.
+ */
+struct OptimizationPass
+{
+    std::string optimizer;                               // "odt", "lloyd", "perturb" or "exude".
+    double time_limit = 0;
+    double seconds = 0;
+    double min_dihedral_angle_before = 0;
+    double min_dihedral_angle_after = 0;
+    double min_radius_ratio_before = 0;
+    double min_radius_ratio_after = 0;
+    bool completed = false;
+};
+
+// DocString: SurfaceClash
+/**
+ * \struct SurfaceClash
+ * A pair of input surfaces that intersect or violate the nesting of the subdomain map, found by Domain::check_surfaces.
+ * The two surface numbers are equal for a self-intersection.
+ */
+struct SurfaceClash
+{
+    int first = 0;
+    int second = 0;
+    std::string type;                                    // "self_intersection", "intersection" or "nesting".
+    std::size_t count = 0;                               // the number of intersecting triangle pairs.
+    std::array<double,3> location{{0, 0, 0}};
+};
+
 // DocString: Domain
 /**
  * \class Domain
@@ -342,6 +446,7 @@ class Domain {
      typedef CGAL::Exact_predicates_inexact_constructions_kernel Kernel;
 
      typedef Kernel::Triangle_3 Triangle_3;
+     typedef Kernel::Segment_3 Segment_3;
      typedef Kernel::Point_3 Point_3;
      typedef Kernel::FT FT;
      typedef CGAL::Mesh_polyhedron_3<Kernel>::type Polyhedron; 
@@ -374,6 +479,25 @@ class Domain {
      typedef CGAL::Mesh_constant_domain_field_3<Tr::Geom_traits,
                                           Mesh_domain::Index> Sizing_field;
 
+    /**
+     * @brief Sizing field with one value inside a bounding box and another outside.
+     */
+     struct Region_sizing_field
+     {
+        typedef Kernel::FT FT;
+        typedef Kernel::Point_3 Point_3;
+        typedef Mesh_domain::Index Index;
+
+        CGAL::Bbox_3 bbox;
+        double inside;
+        double outside;
+
+        FT operator()(const Point_3& p, const int, const Index&) const
+        {
+           return CGAL::do_overlap(p.bbox(), bbox) ? inside : outside;
+        }
+     };
+
      typedef CGAL::Triple<Cell_handle, int, int> Edge; 
 
      typedef Tr::Finite_vertices_iterator Finite_vertices_iterator;
@@ -386,30 +510,45 @@ class Domain {
      typedef std::map<std::string, double> Parameters;     
      typedef std::vector<std::size_t>  Face; 
 
+     // The second subdomain of the surface patch of the facets on the cut by the region of interest.
+     static constexpr int region_of_interest_patch = -1;
+
      // DocString: Domain
     /**
      * @brief Constructor for meshing a single surface  
      * @param surface SVMTK Surface object.
      * @param error_bound allowed error of the surface representation
+     * @param validate option to check the surface for self-intersections, @see check_surfaces.
+     * @throws InvalidArgumentError if validate is true and the surface self-intersects.
      */
      template<typename Surface>
-     Domain(Surface &surface,double error_bound=1.e-7) 
+     Domain(Surface &surface,double error_bound=1.e-7, bool validate=false) 
      {
+        ScopedTimer timer("Domain::Domain");
         this->resolution = surface.get_mesh_resolution();
         if( !surface.does_bound_a_volume() )
            surface.fill_holes();
        
         Polyhedron polyhedron;
-        surface.get_polyhedron(polyhedron);
-
+        {
+           ScopedTimer phase_timer("Domain::polyhedron_conversion");
+           surface.get_polyhedron(polyhedron);
+        }
         min_sphere.add_polyhedron(polyhedron);
-        Polyhedral_mesh_domain_3 *polyhedral_domain = new Polyhedral_mesh_domain_3(polyhedron);
-
+        add_reference_surface(polyhedron);
+        polyhedral_domain_bytes += polyhedral_domain_memory_usage(polyhedron);
+        Polyhedral_mesh_domain_3 *polyhedral_domain;
+        {
+           ScopedTimer phase_timer("Domain::polyhedral_domain");
+           polyhedral_domain = new Polyhedral_mesh_domain_3(polyhedron);
+        }
+        counters->increment(QueryCounters::AABB_TREE_CONSTRUCTIONS);
         this->v.push_back(polyhedral_domain);
         map_ptr = std::shared_ptr<DefaultMap>( new  DefaultMap());
-
-        Function_wrapper wrapper(this->v,map_ptr);
-        domain_ptr=std::unique_ptr<Mesh_domain> (new Mesh_domain( Labeled_Mesh_Domain(wrapper,wrapper.bbox(),FT(error_bound)))); 
+        this->error_bound = error_bound;
+        set_mesh_domain();
+        if( validate )
+          assert_no_surface_clashes();
      }
 
      // DocString: Domain
@@ -417,29 +556,18 @@ class Domain {
      * @brief Constructor for meshing multiple surfaces 
      * @param surfaces a vector of SVMTK Surface objects
      * @param error_bound allowed error of the surface representation
+     * @param validate option to check the surfaces for intersections, @see check_surfaces.
+     * @throws InvalidArgumentError if validate is true and the surfaces clash.
      */   
      template<typename Surface>
-     Domain( std::vector<Surface> surfaces ,double error_bound=1.e-7) 
+     Domain( std::vector<Surface> surfaces ,double error_bound=1.e-7, bool validate=false) 
      {
+        ScopedTimer timer("Domain::Domain");
         this->resolution = 0;
-        for(typename std::vector<Surface>::iterator sit= surfaces.begin(); sit!= surfaces.end(); sit++)
-        {
-           if( sit->get_mesh_resolution() > this->resolution) 
-              this->resolution = sit->get_mesh_resolution();
-              
-           if( !sit->does_bound_a_volume() )
-             sit->fill_holes();       
-           Polyhedron polyhedron;
-           sit->get_polyhedron(polyhedron);
-           min_sphere.add_polyhedron(polyhedron);
-           Polyhedral_mesh_domain_3 *polyhedral_domain = new Polyhedral_mesh_domain_3(polyhedron);
-           this->v.push_back(polyhedral_domain);
-        }
         map_ptr = std::shared_ptr<DefaultMap>(new  DefaultMap()); 
-        Function_wrapper wrapper(this->v, map_ptr);
-
-        domain_ptr=std::unique_ptr<Mesh_domain>(new Mesh_domain(
-               Labeled_Mesh_Domain(wrapper,wrapper.bbox(),FT(error_bound) ))); 
+        set_meshing_inputs(surfaces, error_bound);
+        if( validate )
+          assert_no_surface_clashes();
      }
 
      // DocString: Domain
@@ -448,26 +576,18 @@ class Domain {
      * @param surfaces a vector of SVMTK Surface objects
      * @param map SVMTK SubDomainMap object, setting subdomain and boundary tags. 
      * @param error_bound allowed error of the surface representation
+     * @param validate option to check the surfaces for intersections and the nesting of the map, @see check_surfaces.
+     * @throws InvalidArgumentError if validate is true and the surfaces clash.
      */          
      template<typename Surface>
-     Domain( std::vector<Surface> surfaces , std::shared_ptr<AbstractMap> map, double error_bound=1.e-7)
+     Domain( std::vector<Surface> surfaces , std::shared_ptr<AbstractMap> map, double error_bound=1.e-7, bool validate=false)
      {
+        ScopedTimer timer("Domain::Domain");
         this->resolution = 0;
-        for(typename std::vector<Surface>::iterator sit=surfaces.begin(); sit!= surfaces.end(); sit++)
-        {
-           if( sit->get_mesh_resolution() > this->resolution) 
-              this->resolution = sit->get_mesh_resolution();
-           if( !sit->does_bound_a_volume() )
-              sit->fill_holes();
-           Polyhedron polyhedron; 
-           sit->get_polyhedron(polyhedron);
-           min_sphere.add_polyhedron(polyhedron);
-           Polyhedral_mesh_domain_3 *polyhedral_domain = new Polyhedral_mesh_domain_3(polyhedron);
-           this->v.push_back(polyhedral_domain);
-        }
         map_ptr = std::move(map);
-        Function_wrapper wrapper(this->v,map_ptr);
-        domain_ptr=std::unique_ptr<Mesh_domain>(new Mesh_domain( Labeled_Mesh_Domain(wrapper,wrapper.bbox(),FT(error_bound)))); 
+        set_meshing_inputs(surfaces, error_bound);
+        if( validate )
+          assert_no_surface_clashes();
      }
 
 
@@ -479,8 +599,136 @@ class Domain {
      */
      double get_bounding_sphere_radius()
      { 
+          assert_meshing_inputs();
           return min_sphere.get_bounding_sphere_radius();
      }
+
+    // DocString: get_counters
+    /**
+     * @brief Returns the number of labeling calls, inside evaluations and AABB tree constructions.
+     *
+     * Each labeling call evaluates is_in_domain_object once for every surface in the domain. 
+     * @returns a map with counter names as keys and counts as values.
+     */
+     std::map<std::string,std::size_t> get_counters()
+     {
+        return counters->get_counters();
+     }
+
+    // DocString: reset_counters
+    /**
+     * @brief Sets all query counters to zero.
+     */
+     void reset_counters()
+     {
+        counters->reset();
+     }
+
+    // DocString: memory_report
+    /**
+     * @brief Returns an estimate of the memory held by the Domain object, broken down by component.
+     *
+     * The components are the polyhedral mesh domains with their AABB trees, the surface points 
+     * stored for the bounding sphere, the triangulation, the 1D features and corners of the complex,
+     * the added borders and features, the reference surfaces of morph, and the triangle and point data.
+     * @note The estimate counts the size of the stored elements, and not the allocator overhead.
+     * @returns a map with component names as keys and bytes as values, including the key "total".
+     */
+     std::map<std::string,std::size_t> memory_report()
+     {
+        std::map<std::string,std::size_t> report;
+        const Tr& tr = c3t3.triangulation();
+        report["polyhedral_domains"] = finalized ? 0 : polyhedral_domain_bytes;
+        report["bounding_sphere_points"] = min_sphere.memory_usage();
+        report["triangulation"] = tr.tds().vertices().capacity()*sizeof(Tr::Vertex)
+                                + tr.tds().cells().capacity()*sizeof(Tr::Cell);
+        // Edges and corners are stored in node based containers, with about four pointers per node. 
+        report["complex_edges_and_corners"] = c3t3.number_of_edges_in_complex()*(2*sizeof(Vertex_handle)+sizeof(Curve_index)+6*sizeof(void*))
+                                            + c3t3.number_of_vertices_in_complex()*(sizeof(Vertex_handle)+sizeof(Corner_index)+4*sizeof(void*));
+        std::size_t polyline_points = 0;
+        for(auto const& polyline : borders)
+           polyline_points += polyline.capacity();
+        for(auto const& polyline : features)
+           polyline_points += polyline.capacity();
+        report["borders_and_features"] = polyline_points*sizeof(Point_3);
+        report["reference_surfaces"] = 0;
+        for(std::size_t i = 0; i < reference_points.size(); ++i)
+           report["reference_surfaces"] += reference_points[i].capacity()*sizeof(Point_3) + reference_faces[i].size()*(sizeof(Face)+3*sizeof(std::size_t));
+        report["data"] = triangle_data.capacity()*sizeof(std::pair<Triangle_3,double>)
+                       + point_data.capacity()*sizeof(std::pair<Point_3,double>)
+                       + data_vertices.capacity()*sizeof(Vertex_handle)
+                       + data_cells.capacity()*sizeof(Cell_handle)
+                       + data_facets.capacity()*sizeof(Facet)
+                       + output_vertices.capacity()*sizeof(Vertex_handle)
+                       + output_cells.capacity()*sizeof(Cell_handle);
+        for(auto const& field : data_fields)
+           report["data"] += field.second.values.capacity()*sizeof(double);
+        std::size_t total = 0;
+        for(auto const& component : report)
+           total += component.second;
+        report["total"] = total;
+        return report;
+     }
+
+    // DocString: finalize
+    /**
+     * @brief Releases the meshing inputs, i.e. the polyhedral mesh domains with their AABB trees,
+     *        the labeled mesh domain and the surface points stored for the bounding sphere.
+     *
+     * The mesh is kept, and can still be queried, exuded and saved. Functions that require the 
+     * meshing inputs, i.e. create_mesh, lloyd, odt and perturb, throw a PreconditionError after this call.
+     * Use when no further refinement is needed, and several large meshes are held at once.
+     */
+     void finalize()
+     {
+        if( finalized )
+          return;
+        number_of_input_surfaces = v.size();
+        clear_meshing_inputs();
+        finalized = true;
+     }
+
+    // DocString: set_verbose
+    /**
+     * @brief Sets if the meshing progress is printed to stdout, which is the default.
+     * @param value false to mesh silently, e.g. on worker threads.
+     */
+     void set_verbose(bool value)
+     {
+        verbose = value;
+     }
+
+    // DocString: is_regular
+    /**
+     * @brief Returns true if the mesh is a regular triangulation. The meshes of refine and of morph 
+     *        without remeshing are not, and vertices can not be removed from them, e.g. by exude.
+     * @returns true if the mesh is a regular triangulation.
+     */
+     bool is_regular()
+     {
+        return regular;
+     }
+
+    // DocString: is_completed
+    /**
+     * @brief Returns false if the last meshing of this Domain object was stopped by the active CancellationToken,
+     *        e.g. for the meshes of create_mesh_sweep.
+     * @returns true if the last meshing was completed.
+     */
+     bool is_completed()
+     {
+        return completed;
+     }
+
+    // DocString: is_finalized
+    /**
+     * @brief Returns true if the meshing inputs are released with finalize().
+     * @returns true if the meshing inputs are released.
+     */
+     bool is_finalized()
+     {
+        return finalized;
+     }
   
     // DocString: number_of_subdomains   
     /**
@@ -549,7 +797,7 @@ class Domain {
      */  
      int number_of_surfaces()
      {
-        return v.size();
+        return finalized ? number_of_input_surfaces : v.size();
      }
      
     // DocString: clear_borders
@@ -589,6 +837,164 @@ class Domain {
      {
         features.push_back(polyline);
      } 
+
+     // DocString: set_region_of_interest
+    /**
+     * @brief Restricts the meshing to an iso-cuboid, i.e. points outside the box get the label 0 without 
+     *        evaluating the surfaces, and the bounding box of the mesh domain is clipped to the box.
+     *
+     * The facets of the cut have the surface patch (tag, region_of_interest_patch), and get their own 
+     * interface tag. With a SubdomainMap with interfaces, the cut tag is set with add_interface.
+     * The curves where the boundary of the region cuts the surfaces are protected as 1D features, 
+     * so that the cut follows them instead of being resolved by refinement.
+     * @param xmin the minimum x coordinate of the box.
+     * @param ymin the minimum y coordinate of the box.
+     * @param zmin the minimum z coordinate of the box.
+     * @param xmax the maximum x coordinate of the box.
+     * @param ymax the maximum y coordinate of the box.
+     * @param zmax the maximum z coordinate of the box.
+     * @throws InvalidArgumentError if the box is empty or does not overlap the surfaces.
+     * @throws PreconditionError if the meshing inputs are released.
+     */
+     void set_region_of_interest(double xmin, double ymin, double zmin, double xmax, double ymax, double zmax)
+     {
+        assert_meshing_inputs();
+        if( xmin>=xmax or ymin>=ymax or zmin>=zmax )
+          throw InvalidArgumentError("The minimum coordinates of the box must be less than the maximum coordinates.");
+        std::shared_ptr<Region_of_interest> region(new Region_of_interest);
+        region->is_inside = [=](const Point_3& p)
+        {
+           return p.x()>=xmin and p.x()<=xmax and p.y()>=ymin and p.y()<=ymax and p.z()>=zmin and p.z()<=zmax;
+        };
+        region->distance = [=](const Point_3& p)
+        {
+           double distance = std::max({xmin-p.x(), p.x()-xmax, ymin-p.y(), p.y()-ymax, zmin-p.z(), p.z()-zmax});
+           return std::abs(distance);
+        };
+        region->bbox = CGAL::Bbox_3(xmin, ymin, zmin, xmax, ymax, zmax);
+        use_region_of_interest(region);
+     }
+
+     // DocString: set_region_of_interest
+    /**
+     * @brief Restricts the meshing to a sphere.
+     * @param x the x coordinate of the center.
+     * @param y the y coordinate of the center.
+     * @param z the z coordinate of the center.
+     * @param radius the radius of the sphere.
+     * @throws InvalidArgumentError if the radius is not positive or the sphere does not overlap the surfaces.
+     * @throws PreconditionError if the meshing inputs are released.
+     * @overload
+     */
+     void set_region_of_interest(double x, double y, double z, double radius)
+     {
+        assert_meshing_inputs();
+        if( radius<=0 )
+          throw InvalidArgumentError("The radius must be positive.");
+        Point_3 center(x, y, z);
+        std::shared_ptr<Region_of_interest> region(new Region_of_interest);
+        region->is_inside = [=](const Point_3& p) { return CGAL::squared_distance(p, center)<=radius*radius; };
+        region->distance = [=](const Point_3& p) { return std::abs(std::sqrt(CGAL::squared_distance(p, center)) - radius); };
+        region->bbox = CGAL::Bbox_3(x-radius, y-radius, z-radius, x+radius, y+radius, z+radius);
+        use_region_of_interest(region);
+     }
+
+     // DocString: set_region_of_interest
+    /**
+     * @brief Restricts the meshing to the inside of a closed surface.
+     * @tparam Surface SVMTK Surface class.
+     * @param surface the SVMTK Surface object that bounds the region.
+     * @throws InvalidArgumentError if the surface does not overlap the surfaces.
+     * @throws PreconditionError if the meshing inputs are released.
+     * @overload
+     */
+     template<typename Surface>
+     void set_region_of_interest(Surface& surface)
+     {
+        typedef std::vector<Triangle_3>::const_iterator Triangle_iterator;
+        typedef CGAL::AABB_triangle_primitive<Kernel, Triangle_iterator> Primitive;
+        typedef CGAL::AABB_tree<CGAL::AABB_traits<Kernel, Primitive>> Tree;
+        assert_meshing_inputs();
+        Polyhedron polyhedron;
+        surface.get_polyhedron(polyhedron);
+        std::shared_ptr<Polyhedral_mesh_domain_3> inside(new Polyhedral_mesh_domain_3(polyhedron));
+        std::shared_ptr<std::vector<Triangle_3>> triangles(new std::vector<Triangle_3>());
+        for(auto fit = polyhedron.facets_begin(); fit != polyhedron.facets_end(); ++fit)
+        {
+           auto h = fit->halfedge();
+           triangles->push_back(Triangle_3(h->vertex()->point(), h->next()->vertex()->point(), h->next()->next()->vertex()->point()));
+        }
+        std::shared_ptr<Tree> tree(new Tree(triangles->begin(), triangles->end()));
+        tree->accelerate_distance_queries();
+        std::shared_ptr<Region_of_interest> region(new Region_of_interest);
+        region->is_inside = [inside](const Point_3& p) { return static_cast<bool>(inside->is_in_domain_object()(p)); };
+        region->distance = [triangles, tree](const Point_3& p) { return std::sqrt(CGAL::to_double(tree->squared_distance(p))); };
+        region->bbox = inside->bbox();
+        use_region_of_interest(region);
+     }
+
+     // DocString: clear_region_of_interest
+    /**
+     * @brief Removes the region of interest, so that the whole bounding box of the surfaces is meshed.
+     * @throws PreconditionError if the meshing inputs are released.
+     */
+     void clear_region_of_interest()
+     {
+        assert_meshing_inputs();
+        roi.reset();
+        set_mesh_domain();
+     }
+
+     // DocString: add_intersection_features
+    /**
+     * @brief Adds the intersection curves of the input surfaces to the Domain member features, so that
+     *        the curves are protected instead of resolved by refinement.
+     *
+     * The intersection polylines of each pair of surfaces with overlapping bounding boxes are computed
+     * concurrently with CGAL::Polygon_mesh_processing::surface_intersection. Polylines of surface pairs 
+     * with a common surface are split where they cross, so that the junctions become corners, 
+     * i.e. protecting balls, of the 1D features.
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     * @returns the number of added polylines.
+     * @throws PreconditionError if the meshing inputs are released.
+     */
+     int add_intersection_features(int num_threads=0)
+     {
+        ScopedTimer timer("Domain::add_intersection_features");
+        assert_meshing_inputs();
+        typedef CGAL::Surface_mesh<Point_3> Mesh;
+        std::size_t n = reference_points.size();
+        std::vector<CGAL::Bbox_3> boxes(n);
+        for(std::size_t i = 0; i < n; ++i)
+           for(const Point_3& p : reference_points[i])
+              boxes[i] += p.bbox();
+        std::vector<std::pair<std::size_t,std::size_t>> pairs;
+        for(std::size_t i = 0; i < n; ++i)
+           for(std::size_t j = i+1; j < n; ++j)
+              if( CGAL::do_overlap(boxes[i], boxes[j]) )
+                pairs.push_back(std::make_pair(i, j));
+
+        std::vector<Polylines> curves(pairs.size());
+        // Each pair builds its own surface meshes, so that the threads share no mutable data.
+        parallel_for(pairs.size(), num_threads, [&](std::size_t k)
+        {
+           Mesh first, second;
+           CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(reference_points[pairs[k].first], reference_faces[pairs[k].first], first);
+           CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(reference_points[pairs[k].second], reference_faces[pairs[k].second], second);
+           CGAL::Polygon_mesh_processing::surface_intersection(first, second, std::back_inserter(curves[k]));
+        });
+
+        double tolerance = 1.e-8*min_sphere.get_bounding_sphere_radius();
+        Polylines polylines = split_at_junctions(curves, pairs, tolerance);
+        int added = 0;
+        for(auto& polyline : polylines)
+           if( polyline.size()>1 )
+           {
+             features.push_back(polyline);
+             added++;
+           }
+        return added;
+     }
     
     /**
      * @brief Returns Domain object member variable features as polylines.
@@ -599,6 +1005,7 @@ class Domain {
         return features;
      }  
     
+    // DocString: get_borders
     /**
      * @brief Returns the borders added to the Domain object
      * @returns the Domain borders as polylines.
@@ -647,9 +1054,12 @@ class Domain {
      * @param c3t3 the mesh structure stored in the Domain class Obejct
      * @param remove_domain indication if a subdomain is removed, avoiding warning. 
      * @returns the number of vertices removed.
+     * @throws PreconditionError if the mesh is not a regular triangulation, @see is_regular().
      */
      int remove_isolated_vertices(bool remove_domain=false)
      { 
+        ScopedTimer timer("Domain::remove_isolated_vertices");
+        assert_regular_triangulation();
         std::map<Vertex_handle, bool> vertex_map;
         for(Finite_vertices_iterator vit = c3t3.triangulation().finite_vertices_begin();vit != c3t3.triangulation().finite_vertices_end();++vit)
            vertex_map[vit] = false;  
@@ -665,6 +1075,8 @@ class Domain {
                  c3t3.triangulation().remove(it->first);
         }
         int after = c3t3.triangulation().number_of_vertices(); 
+        if( !verbose )
+          return (before - after);
 
         std::cout<<"Number of isolated vertices removed: "<< before - after << std::endl;
         double vertices_removed_ratio = 1.0 - (double)after/(double)before;
@@ -721,6 +1133,7 @@ class Domain {
      */
      void rebind_missing_facets()
      {
+        ScopedTimer timer("Domain::rebind_missing_facets");
         for(C3t3::Cells_in_complex_iterator cit = c3t3.cells_in_complex_begin();cit != c3t3.cells_in_complex_end(); ++cit)
         {
            Cell_handle cn = cit;
@@ -764,6 +1177,145 @@ class Domain {
        return true;
      }
 
+    /**
+     * @brief Checks that the meshing inputs are not released with finalize().
+     * @throws PreconditionError if the meshing inputs are released.
+     */
+     void assert_meshing_inputs()
+     {
+       if( finalized )
+         throw PreconditionError("Meshing inputs are released by finalize().");
+     }
+
+    /**
+     * @brief Checks that the mesh is a regular triangulation, which is required to remove vertices 
+     *        and to change vertex weights.
+     * @throws PreconditionError if the mesh is not a regular triangulation, i.e. after refine or morph.
+     */
+     void assert_regular_triangulation()
+     {
+       if( !regular )
+         throw PreconditionError("The mesh is not a regular triangulation, e.g. after refine or morph.");
+     }
+
+     // DocString: check_surfaces
+    /**
+     * @brief Checks the input surfaces for clashes that make the meshing fail or run for a long time.
+     *
+     * Candidate triangle pairs of all surfaces are found with box intersection, and the candidates are 
+     * tested for intersection concurrently. Triangles of the same surface that share a vertex are not tested.
+     * For a SubdomainMap, a surface is implied to be nested inside another surface if every tagged region 
+     * inside the first surface is also inside the second, and the nesting is checked for surfaces that do not 
+     * intersect. 
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     * @returns the clashes, i.e. one for each self-intersecting surface, each pair of intersecting surfaces 
+     *          and each violated nesting.
+     * @throws PreconditionError if the meshing inputs are released.
+     */
+     std::vector<SurfaceClash> check_surfaces(int num_threads=0)
+     {
+        ScopedTimer timer("Domain::check_surfaces");
+        assert_meshing_inputs();
+        typedef CGAL::Box_intersection_d::Box_with_info_d<double,3,std::size_t> Box;
+        std::vector<Triangle_3> triangles;
+        std::vector<std::pair<std::size_t,std::array<std::size_t,3>>> triangle_corners;
+        for(std::size_t i = 0; i < reference_faces.size(); ++i)
+           for(const Face& face : reference_faces[i])
+              for(std::size_t k = 1; k+1 < face.size(); ++k)
+              {
+                 triangles.push_back(Triangle_3(reference_points[i][face[0]], reference_points[i][face[k]], reference_points[i][face[k+1]]));
+                 triangle_corners.push_back(std::make_pair(i, std::array<std::size_t,3>{face[0], face[k], face[k+1]}));
+              }
+        std::vector<Box> boxes;
+        boxes.reserve(triangles.size());
+        for(std::size_t t = 0; t < triangles.size(); ++t)
+           if( !triangles[t].is_degenerate() )
+             boxes.push_back(Box(triangles[t].bbox(), t));
+
+        std::vector<std::pair<std::size_t,std::size_t>> candidates;
+        {
+           ScopedTimer phase_timer("Domain::box_intersection");
+           CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), [&](const Box& a, const Box& b)
+           {
+              const auto& first = triangle_corners[a.info()];
+              const auto& second = triangle_corners[b.info()];
+              if( first.first==second.first )
+                for(std::size_t u : first.second)
+                   if( std::find(second.second.begin(), second.second.end(), u)!=second.second.end() )
+                     return;
+              candidates.push_back(std::make_pair(a.info(), b.info()));
+           });
+        }
+
+        // The triangle tests are independent, and each thread collects its own intersecting pairs.
+        std::size_t number_of_threads = thread_count(num_threads, candidates.size());
+        std::vector<std::vector<std::pair<std::size_t,std::size_t>>> hits(number_of_threads);
+        {
+           ScopedTimer phase_timer("Domain::triangle_intersection");
+           parallel_for(number_of_threads, number_of_threads, [&](std::size_t n)
+           {
+              for(std::size_t c = n; c < candidates.size(); c += number_of_threads)
+                 if( CGAL::do_intersect(triangles[candidates[c].first], triangles[candidates[c].second]) )
+                   hits[n].push_back(candidates[c]);
+           });
+        }
+
+        std::map<std::pair<int,int>,SurfaceClash> clashes;
+        for(auto const& thread_hits : hits)
+           for(auto const& hit : thread_hits)
+           {
+              int i = static_cast<int>(triangle_corners[hit.first].first);
+              int j = static_cast<int>(triangle_corners[hit.second].first);
+              SurfaceClash& clash = clashes[std::minmax(i, j)];
+              if( clash.count==0 )
+              {
+                clash.first = std::min(i, j);
+                clash.second = std::max(i, j);
+                clash.type = i==j ? "self_intersection" : "intersection";
+                Point_3 p = CGAL::centroid(triangles[hit.first]);
+                clash.location = {{p.x(), p.y(), p.z()}};
+              }
+              clash.count++;
+           }
+
+        // The nesting implied by the tagged regions of a SubdomainMap.
+        SubdomainMap* subdomain_map = dynamic_cast<SubdomainMap*>(map_ptr.get());
+        if( subdomain_map )
+        {
+          std::map<std::string,int> regions = subdomain_map->get_map();
+          int n = static_cast<int>(v.size());
+          for(int i = 0; i < n; ++i)
+             for(int j = 0; j < n; ++j)
+             {
+                if( i==j or clashes.count(std::minmax(i, j)) or reference_points[i].empty() )
+                  continue;
+                bool is_tagged = false, is_nested = true;
+                for(auto const& region : regions)
+                {
+                   if( static_cast<int>(region.first.size())!=n or region.second==0 or region.first[i]!='1' )
+                     continue;
+                   is_tagged = true;
+                   is_nested = is_nested and region.first[j]=='1';
+                }
+                if( !is_tagged or !is_nested )
+                  continue;
+                const Point_3& p = reference_points[i].front();
+                if( static_cast<bool>(v[j]->is_in_domain_object()(p)) )
+                  continue;
+                SurfaceClash& clash = clashes[std::make_pair(i, j)];
+                clash.first = i;
+                clash.second = j;
+                clash.type = "nesting";
+                clash.count = 1;
+                clash.location = {{p.x(), p.y(), p.z()}};
+             }
+        }
+        std::vector<SurfaceClash> result;
+        for(auto const& clash : clashes)
+           result.push_back(clash.second);
+        return result;
+     }
+
      // DocString: boudnary_segmentations
     /** 
      * @brief Segments the boundary of a specified subdomain tag.
@@ -926,8 +1478,23 @@ class Domain {
      */
      void set_features()
      {
-        if( this->features.size()>0 )
-          domain_ptr.get()->add_features(this->features.begin(), this->features.end()); 
+        Polylines polylines = mesh_features();
+        if( polylines.size()>0 )
+          domain_ptr.get()->add_features(polylines.begin(), polylines.end()); 
+     }
+
+    /**
+     * @brief Adds the borders and the features to the labeled mesh domain, @see set_borders() and set_features().
+     *        If they were added before, the labeled mesh domain is reconstructed first, so that each 1D feature 
+     *        is added once, also when the mesh is created again after new features are added.
+     */
+     void register_features()
+     {
+        if( features_registered )
+          set_mesh_domain();
+        set_borders();
+        set_features();
+        features_registered = true;
      }
 
      // DocString: get_cruve_tags
@@ -944,6 +1511,35 @@ class Domain {
         return result;       
      }
 
+    /**
+     * @brief Post-processing of the mesh after CGAL make_mesh_3.
+     *
+     * If refinement was stopped by the active CancellationToken, the mesh 
+     * is the partially refined mesh at the time of cancellation.
+     * @returns true if the refinement was completed, @see is_completed().
+     */
+     bool complete_meshing()
+     {
+        completed = !cancellation_requested();
+        // The meshes of CGAL Mesh_3 are regular triangulations.
+        regular = true;
+        clear_mesh_data();
+        remove_isolated_vertices();
+        {
+           ScopedTimer timer("Domain::rescan_after_load_of_triangulation");
+           c3t3.rescan_after_load_of_triangulation();
+        }
+        rebind_missing_facets();
+        mark_region_of_interest_boundary();
+        if( !verbose )
+          return completed;
+        if( completed )
+          std::cout << "Done meshing" << std::endl;
+        else
+          std::cout << "Meshing stopped before completion" << std::endl;
+        return completed;
+     }
+
      // DocString: create_mesh 
     /** 
      * @brief Creates the mesh stored in the class member variable c3t3. 
@@ -955,11 +1551,13 @@ class Domain {
      * @param facet_angle mesh criteria for the minimum edge size 
      * @param facet_distance mesh criteria for surface approximation  
      * @param cell_radius_edge_ratio mesh criteria for the relation between cell rddius and edge
+     * @returns true if completed, false if stopped by the active CancellationToken. 
      */
-     void create_mesh(double edge_size,double cell_size, double facet_size,double facet_angle,  double facet_distance,double cell_radius_edge_ratio)
+     bool create_mesh(double edge_size,double cell_size, double facet_size,double facet_angle,  double facet_distance,double cell_radius_edge_ratio)
      {   
-        set_borders();
-        set_features();
+        ScopedTimer timer("Domain::create_mesh");
+        assert_meshing_inputs();
+        register_features();
 
         Mesh_criteria criteria(CGAL::parameters::edge_size = edge_size,
                               CGAL::parameters::facet_angle=facet_angle ,
@@ -968,17 +1566,19 @@ class Domain {
                               CGAL::parameters::cell_radius_edge_ratio=cell_radius_edge_ratio,
                               CGAL::parameters::cell_size=cell_size);
 
-        std::cout << "Start meshing" << std::endl;
-    
-        c3t3 = CGAL::make_mesh_3<C3t3>(*domain_ptr.get(), criteria,CGAL::parameters::no_exude(),  
-                                                                   CGAL::parameters::no_perturb(),
-                                                                   CGAL::parameters::features(),
-                                                                   CGAL::parameters::non_manifold()); 
-    
-        remove_isolated_vertices();
-        c3t3.rescan_after_load_of_triangulation();
-        rebind_missing_facets();        
-        std::cout << "Done meshing" << std::endl;
+        if( verbose )
+          std::cout << "Start meshing" << std::endl;
+        {
+           ScopedTimer timer("Domain::make_mesh_3");
+           DeadlineWatcher watcher;
+           c3t3 = CGAL::make_mesh_3<C3t3>(*domain_ptr.get(), criteria,CGAL::parameters::no_exude(),  
+                                                                      CGAL::parameters::no_perturb(),
+                                                                      CGAL::parameters::features(),
+                                                                      CGAL::parameters::non_manifold(),
+                                                                      CGAL::parameters::mesh_3_options(
+                                                                      CGAL::parameters::pointer_to_stop_atomic_boolean(watcher.stop_flag()))); 
+        }
+        return complete_meshing();
      }
 
      // DocString: create_mesh 
@@ -987,78 +1587,756 @@ class Domain {
      * @note The mesh criteria is set based on mesh_resolution and the minimum bounding radius of the mesh.
      *
      * @param mesh_resolution a value determined 
+     * @returns true if completed, false if stopped by the active CancellationToken. 
      * @overload
      */
-     void create_mesh(const double mesh_resolution)
+     bool create_mesh(const double mesh_resolution)
      {
-        set_borders();
-        set_features();
+        ScopedTimer timer("Domain::create_mesh");
+        assert_meshing_inputs();
+        register_features();
 
         double r = min_sphere.get_bounding_sphere_radius(); 
-        const double cell_size = r/mesh_resolution;
-        std::cout << "Cell size: " << cell_size << std::endl;
-
-        Mesh_criteria criteria(CGAL::parameters::edge_size = cell_size,
-                                        CGAL::parameters::facet_angle = 30.0,
-                                        CGAL::parameters::facet_size = cell_size,
-                                        CGAL::parameters::facet_distance = cell_size/10.0, 
-                                        CGAL::parameters::cell_radius_edge_ratio = 3.0,
-                                        CGAL::parameters::cell_size = cell_size);
-
-        std::cout << "Start meshing" << std::endl;
-        c3t3 = CGAL::make_mesh_3<C3t3>(*domain_ptr.get(), criteria,CGAL::parameters::no_exude());
-   
-        remove_isolated_vertices();
-        c3t3.rescan_after_load_of_triangulation();
-        rebind_missing_facets();
-        std::cout << "Done meshing" << std::endl;
+        if( verbose )
+          std::cout << "Cell size: " << r/mesh_resolution << std::endl;
+        Mesh_criteria criteria = resolution_criteria(r, mesh_resolution);
 
+        if( verbose )
+          std::cout << "Start meshing" << std::endl;
+        {
+           ScopedTimer timer("Domain::make_mesh_3");
+           DeadlineWatcher watcher;
+           c3t3 = CGAL::make_mesh_3<C3t3>(*domain_ptr.get(), criteria,CGAL::parameters::no_exude(),
+                                                                      CGAL::parameters::mesh_3_options(
+                                                                      CGAL::parameters::pointer_to_stop_atomic_boolean(watcher.stop_flag())));
+        }
+        return complete_meshing();
      }
      
-     // DocString: create_mesh     
+     // DocString: create_mesh_sweep
     /** 
-     * @brief Creates the mesh stored in the class member variable c3t3.  
-     *        The mesh resolution is set automatic to the highest mesh resolution of 
-     *        the surface(s).  
-     * @overload
+     * @brief Creates one mesh for each mesh resolution, reusing the polyhedral mesh domains and the labeling oracle.
+     *
+     * Only the refinement is repeated for each resolution, and the refinements run concurrently.
+     * Each refinement has its own labeled mesh domain with the 1D features, while the polyhedral 
+     * mesh domains, i.e. the surfaces and their AABB trees, are shared and only queried, 
+     * as in the parallel refinement of CGAL.
+     * The meshes are returned as finalized Domain objects, @see finalize(), that can be queried, 
+     * exuded and saved separately, and is_completed() is false for the meshes stopped by the active 
+     * CancellationToken. The meshes are created silently and then print as set for this Domain object. 
+     * The mesh stored in this Domain object is not changed.
+     * @param mesh_resolutions vector of mesh resolutions, @see create_mesh(const double)
+     * @param num_threads the number of concurrent refinements, non-positive uses the number of hardware threads. 
+     * @returns a vector of finalized Domain objects in the same order as mesh_resolutions.
      */
-     void create_mesh()
+     std::vector<std::shared_ptr<Domain>> create_mesh_sweep(std::vector<double> mesh_resolutions, int num_threads=0)
      {
-         create_mesh(this->resolution);
+        ScopedTimer timer("Domain::create_mesh_sweep");
+        assert_meshing_inputs();
+        protect_borders();
+
+        double r = min_sphere.get_bounding_sphere_radius(); 
+        Polylines polylines = mesh_features();
+        std::vector<std::shared_ptr<Domain>> result(mesh_resolutions.size());
+        // Each thread refines against its own labeled mesh domain, since the 1D features are stored in it.
+        // The polyhedral mesh domains are shared, and are only read during refinement.
+        parallel_for(mesh_resolutions.size(), num_threads, [&](std::size_t i)
+        {
+           Mesh_criteria criteria = resolution_criteria(r, mesh_resolutions[i]);
+           std::unique_ptr<Mesh_domain> mesh_domain = make_mesh_domain();
+           if( borders.size()>0 )
+             mesh_domain->add_features(borders.begin(), borders.end());
+           if( polylines.size()>0 )
+             mesh_domain->add_features(polylines.begin(), polylines.end());
+           std::shared_ptr<Domain> domain(new Domain(map_ptr, borders, features, resolution, v.size()));
+           {
+              ScopedTimer timer("Domain::make_mesh_3");
+              DeadlineWatcher watcher;
+              domain->c3t3 = CGAL::make_mesh_3<C3t3>(*mesh_domain, criteria,CGAL::parameters::no_exude(),
+                                                                CGAL::parameters::mesh_3_options(
+                                                                CGAL::parameters::pointer_to_stop_atomic_boolean(watcher.stop_flag())));
+           }
+           domain->roi = roi;
+           domain->set_verbose(false);
+           domain->complete_meshing();
+           domain->set_verbose(verbose);
+           result[i] = domain;
+        });
+        return result;
      }
-     
-    // DocString: save   
+
+     // DocString: create_mesh_clusters
     /** 
-     * @brief Writes the mesh stored in the class member variable c3t3 to file.
-     *  
-     * The interface tags are loaded from SubdomainMap added in the constructor. 
-     * If there are no interfaces in SubDomainMap, then default interfaces are 
-     * selected.
+     * @brief Creates the mesh stored in the class member variable c3t3, where spatially separated clusters
+     *        of surfaces, e.g. separate organs, are meshed concurrently. 
      *
-     * @param outpath the path to the output file.
-     * @param save_1Dfeatures option to save the edges with tags.
+     * Surfaces and 1D features are in the same cluster if their bounding boxes are closer than twice the 
+     * cell size. Each cluster is meshed in its own complex against the labeling of all the surfaces restricted 
+     * to the cluster, so the tags are the same as with create_mesh(const double). The complexes are merged
+     * into one mesh with renumbered vertices. If the clusters are too close to be merged, the mesh is created 
+     * with create_mesh(const double).
+     * @param mesh_resolution the mesh resolution, @see create_mesh(const double)
+     * @param num_threads the number of concurrent clusters, non-positive uses the number of hardware threads. 
+     * @returns true if completed, false if stopped by the active CancellationToken. 
      */
-     void save(std::string outpath,bool save_1Dfeatures)
+     bool create_mesh_clusters(double mesh_resolution, int num_threads=0)
      {
-        assert_non_empty_mesh_object();
-        std::ofstream  medit_file(outpath);
-        typedef CGAL::Mesh_3::Medit_pmap_generator<C3t3,false,false> Generator;
-        typedef Generator::Cell_pmap Cell_pmap;
-        typedef Generator::Facet_pmap Facet_pmap;
-        typedef Generator::Facet_pmap_twice Facet_pmap_twice;
-        typedef Generator::Vertex_pmap Vertex_pmap;
- 
-        Cell_pmap cell_pmap(c3t3);
-        Facet_pmap facet_pmap(c3t3, cell_pmap); 
-        Facet_pmap_twice  facet_twice_pmap(c3t3,cell_pmap);
-        Vertex_pmap vertex_pmap(c3t3, cell_pmap,facet_pmap); // -> vertex_pmap
+        ScopedTimer timer("Domain::create_mesh_clusters");
+        assert_meshing_inputs();
+        protect_borders();
 
-        std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
-    
-        output_to_medit_(medit_file, c3t3, vertex_pmap, facet_map, cell_pmap, facet_twice_pmap , false, save_1Dfeatures);
+        double r = min_sphere.get_bounding_sphere_radius(); 
+        const double cell_size = r/mesh_resolution;
+        std::vector<Cluster> clusters = make_clusters(cell_size);
+        if( clusters.size()<2 )
+          return create_mesh(mesh_resolution);
+
+        Mesh_criteria criteria = resolution_criteria(r, mesh_resolution);
+        std::vector<C3t3> complexes(clusters.size());
+        // The polyhedral mesh domains are only read during refinement, and are shared by the threads. 
+        parallel_for(clusters.size(), num_threads, [&](std::size_t i)
+        {
+           const Cluster& cluster = clusters[i];
+           CGAL::Bbox_3 bbox = dilate(cluster.bbox, cell_size);
+           Function_wrapper wrapper(this->v,map_ptr,counters);
+           std::shared_ptr<Region_of_interest> region = roi;
+           wrapper.set_region([bbox, region](const Point_3& p) 
+           {
+              return CGAL::do_overlap(p.bbox(), bbox) and ( !region or region->is_inside(p) );
+           });
+           if( roi )
+           {
+             bbox = clip(bbox, roi->bbox);
+             if( is_empty(bbox) )
+               return;
+           }
+           Mesh_domain domain(Labeled_Mesh_Domain(wrapper,bbox,FT(error_bound)));
+           if( cluster.borders.size()>0 )
+             domain.add_features(cluster.borders.begin(), cluster.borders.end());
+           if( cluster.features.size()>0 )
+             domain.add_features(cluster.features.begin(), cluster.features.end());
+           {
+              ScopedTimer timer("Domain::make_mesh_3");
+              DeadlineWatcher watcher;
+              complexes[i] = CGAL::make_mesh_3<C3t3>(domain, criteria,CGAL::parameters::no_exude(),
+                                                                CGAL::parameters::mesh_3_options(
+                                                                CGAL::parameters::pointer_to_stop_atomic_boolean(watcher.stop_flag())));
+           }
+        });
+
+        if( !merge_complexes(complexes) )
+          return create_mesh(mesh_resolution);
+        return complete_meshing();
+     }
+
+     // DocString: refine
+    /** 
+     * @brief Returns a copy of the mesh where each cell is split into 8 cells by red refinement, 
+     *        i.e. at the midpoints of its edges.
+     *
+     * The vertices of the mesh are kept, and the subdomain, surface patch, curve and corner tags 
+     * are inherited by the refined cells, facets, edges and vertices. If only some subdomains are refined, 
+     * the neighbouring cells are split into 2 or 4 cells at the refined edges, so that the mesh is conforming, 
+     * or refined if the refined edges do not allow that. The cells outside the complex are refined in the same
+     * way, so that the result is a valid triangulation of the convex hull. 
+     *
+     * The refined mesh is in general not a regular triangulation, so it is returned as a finalized Domain object, 
+     * @see finalize() and is_regular(), that can be queried and saved, but not remeshed, optimized or exuded, 
+     * and subdomains can not be removed.
+     * The refined cells are constructed concurrently.
+     * @param levels the number of refinements.
+     * @param subdomains the subdomain tags of the refined cells, empty refines all cells.
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads. 
+     * @returns a finalized Domain object with the refined mesh.
+     * @throws InvalidArgumentError if the number of levels is negative.
+     */
+     std::shared_ptr<Domain> refine(int levels=1, std::vector<int> subdomains={}, int num_threads=0)
+     {
+        ScopedTimer timer("Domain::refine");
+        assert_non_empty_mesh_object();
+        if( levels<0 )
+          throw InvalidArgumentError("The number of refinement levels must be non-negative.");
+        std::shared_ptr<Domain> domain(new Domain(map_ptr, borders, features, resolution, number_of_surfaces()));
+        domain->c3t3 = c3t3;
+        std::set<int> tags(subdomains.begin(), subdomains.end());
+        for(int level = 0; level < levels and !cancellation_requested(); ++level)
+        {
+           C3t3 refined;
+           red_refinement(domain->c3t3, refined, tags, num_threads);
+           domain->c3t3.swap(refined);
+        }
+        domain->regular = levels==0;
+        return domain;
+     }
+
+     // DocString: remesh_subdomains
+    /** 
+     * @brief Remeshes the subdomains with the given tags against an updated set of surfaces, and 
+     *        keeps the rest of the mesh.
+     *
+     * The meshing inputs are replaced by the updated surfaces with the same subdomain map. The vertices 
+     * inside the subdomains and a buffer of cell layers around them are removed, except the vertices 
+     * that protect 1D features, and the mesh is then refined with CGAL refine_mesh_3. The cells outside 
+     * the removed region are not changed, so the remeshed region conforms to the rest of the mesh, and the 
+     * refinement only inserts vertices where the mesh criteria are not met, i.e. mainly in the removed region.
+     * 
+     * The subdomain and interface tags of the whole mesh are recomputed against the updated surfaces, 
+     * so subdomains removed with remove_subdomain are restored. 
+     * @param surfaces the updated vector of SVMTK Surface objects, with the same order as the constructor. 
+     * @param subdomains the subdomain tags of the remeshed cells.
+     * @param buffer_layers the number of cell layers around the subdomains that are also remeshed. 
+     * @param mesh_resolution the mesh resolution, @see create_mesh(const double), non-positive uses the 
+     *                        resolution of the surfaces.
+     * @param error_bound allowed error of the surface representation.
+     * @returns true if completed, false if stopped by the active CancellationToken.
+     * @throws InvalidArgumentError if the number of surfaces does not match.
+     */
+     template<typename Surface>
+     bool remesh_subdomains(std::vector<Surface> surfaces, std::vector<int> subdomains, int buffer_layers=1, 
+                            double mesh_resolution=0, double error_bound=1.e-7)
+     {
+        ScopedTimer timer("Domain::remesh_subdomains");
+        assert_non_empty_mesh_object();
+        assert_regular_triangulation();
+        if( static_cast<int>(surfaces.size())!=number_of_surfaces() )
+          throw InvalidArgumentError("The number of surfaces must match the number of surfaces of the mesh.");
+        clear_mesh_data();
+        clear_meshing_inputs();
+        this->resolution = 0;
+        set_meshing_inputs(surfaces, error_bound);
+        finalized = false;
+        register_features();
+        if( mesh_resolution<=0 )
+          mesh_resolution = this->resolution;
+
+        // The region of removed vertices, i.e. the subdomains and the buffer layers.
+        Tr& tr = c3t3.triangulation();
+        std::set<int> tags(subdomains.begin(), subdomains.end());
+        std::set<Cell_handle> region;
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+           if( tags.count(static_cast<int>(c3t3.subdomain_index(cit))) )
+             region.insert(cit);
+        for(int layer = 0; layer < buffer_layers; ++layer)
+        {
+           std::set<Vertex_handle> layer_vertices;
+           for(Cell_handle c : region)
+              for(int i = 0; i < 4; ++i)
+                 layer_vertices.insert(c->vertex(i));
+           for(Vertex_handle vh : layer_vertices)
+           {
+              std::vector<Cell_handle> cells;
+              tr.finite_incident_cells(vh, std::back_inserter(cells));
+              region.insert(cells.begin(), cells.end());
+           }
+        }
+        std::vector<Vertex_handle> removed;
+        std::set<Vertex_handle> visited;
+        for(Cell_handle c : region)
+           for(int i = 0; i < 4; ++i)
+           {
+              Vertex_handle vh = c->vertex(i);
+              if( !visited.insert(vh).second or vh->in_dimension()<2 or tr.point(vh).weight()>0 )
+                continue;
+              std::vector<Cell_handle> cells;
+              tr.incident_cells(vh, std::back_inserter(cells));
+              if( std::all_of(cells.begin(), cells.end(), [&](Cell_handle n) { return region.count(n)>0; }) )
+                removed.push_back(vh);
+           }
+        for(Cell_handle c : region)
+        {
+           for(int i = 0; i < 4; ++i)
+              if( c3t3.is_in_complex(c,i) )
+                c3t3.remove_from_complex(c,i);
+           if( c3t3.is_in_complex(c) )
+             c3t3.remove_from_complex(c);
+        }
+        std::set<Cell_handle>().swap(region);
+        for(Vertex_handle vh : removed)
+           tr.remove(vh);
+        c3t3.rescan_after_load_of_triangulation();
+        return refine_existing_mesh(mesh_resolution);
+     }
+
+     // DocString: morph
+    /** 
+     * @brief Moves the vertices of the mesh onto deformed surfaces with the same vertices and faces 
+     *        as the surfaces of the mesh, without remeshing.
+     *
+     * A boundary vertex of the mesh is moved with the barycentric coordinates of its closest point on the 
+     * reference surfaces, i.e. the surfaces from the constructor or the last morph, and so are the points 
+     * of the borders and features. The displacement of the other vertices is the harmonic extension of the 
+     * boundary displacement, i.e. the solution of the graph Laplace equation, solved with a sparse Cholesky 
+     * factorization. The connectivity and the data fields of the mesh are kept.
+     *
+     * The moved mesh is in general not a regular triangulation, so it is finalized, @see finalize() and 
+     * is_regular(), and can be queried, saved and morphed again, but not exuded. If cells in the complex are inverted or 
+     * have a minimum dihedral angle below the bound, the vertices inside these cells and the buffer layers 
+     * around them are removed, and the triangulation is rebuilt from the other vertices to restore regularity. 
+     * The mesh is then refined against the deformed surfaces and the moved borders and features, where the 
+     * size criteria are only applied in the neighbourhood of the removed vertices, so that the vertices 
+     * elsewhere are kept unless the shape criteria are violated.
+     * @param surfaces the deformed vector of SVMTK Surface objects, with the same order as the constructor.
+     * @param min_dihedral_angle the lower bound on the dihedral angles of the moved cells in degrees.
+     * @param buffer_layers the number of cell layers around the bad cells that are remeshed. 
+     * @param mesh_resolution the mesh resolution of the remeshing, non-positive uses the resolution of the surfaces.
+     * @param error_bound allowed error of the surface representation.
+     * @returns the number of bad cells after the vertices are moved, i.e. 0 if the mesh is not remeshed.
+     * @throws InvalidArgumentError if the surfaces do not match the reference surfaces.
+     * @throws AlgorithmError if the harmonic extension can not be solved.
+     */
+     template<typename Surface>
+     int morph(std::vector<Surface> surfaces, double min_dihedral_angle=0., int buffer_layers=1, 
+               double mesh_resolution=0, double error_bound=1.e-7)
+     {
+        ScopedTimer timer("Domain::morph");
+        assert_non_empty_mesh_object();
+        if( surfaces.size()!=reference_points.size() )
+          throw InvalidArgumentError("The number of surfaces must match the number of reference surfaces.");
+        std::vector<std::vector<Point_3>> points(surfaces.size());
+        for(std::size_t i = 0; i < surfaces.size(); ++i)
+        {
+           Polyhedron polyhedron;
+           surfaces[i].get_polyhedron(polyhedron);
+           std::vector<Face> faces;
+           CGAL::Polygon_mesh_processing::polygon_mesh_to_polygon_soup(polyhedron, points[i], faces);
+           if( points[i].size()!=reference_points[i].size() or faces!=reference_faces[i] )
+             throw InvalidArgumentError(("Surface " + std::to_string(i) + " does not have the vertices and faces of the reference surface.").c_str());
+        }
+
+        // Boundary displacement from the barycentric coordinates on the reference surfaces.
+        typedef std::vector<Triangle_3>::const_iterator Triangle_iterator;
+        typedef CGAL::AABB_triangle_primitive<Kernel, Triangle_iterator> Primitive;
+        typedef CGAL::AABB_tree<CGAL::AABB_traits<Kernel, Primitive>> Tree;
+        std::vector<Triangle_3> triangles;
+        std::vector<std::pair<std::size_t,std::array<std::size_t,3>>> triangle_corners;
+        for(std::size_t i = 0; i < reference_faces.size(); ++i)
+           for(const Face& face : reference_faces[i])
+              for(std::size_t k = 1; k+1 < face.size(); ++k)
+              {
+                 triangles.push_back(Triangle_3(reference_points[i][face[0]], reference_points[i][face[k]], reference_points[i][face[k+1]]));
+                 triangle_corners.push_back(std::make_pair(i, std::array<std::size_t,3>{face[0], face[k], face[k+1]}));
+              }
+        Tree tree(triangles.begin(), triangles.end());
+        tree.accelerate_distance_queries();
+
+        Tr& tr = c3t3.triangulation();
+        std::set<Vertex_handle> boundary;
+        for(Facet_iterator fit = c3t3.facets_in_complex_begin(); fit != c3t3.facets_in_complex_end(); ++fit)
+           for(int i = 0; i < 4; ++i)
+              if( i!=fit->second )
+                boundary.insert(fit->first->vertex(i));
+        for(auto eit = c3t3.edges_in_complex_begin(); eit != c3t3.edges_in_complex_end(); ++eit)
+        {
+           boundary.insert(eit->first->vertex(eit->second));
+           boundary.insert(eit->first->vertex(eit->third));
+        }
+        for(auto vit = c3t3.vertices_in_complex_begin(); vit != c3t3.vertices_in_complex_end(); ++vit)
+           boundary.insert(vit);
+
+        std::map<Vertex_handle,std::size_t> unknown;
+        std::vector<Vertex_handle> interior;
+        for(Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit)
+           if( !boundary.count(vit) )
+           {
+             unknown[vit] = interior.size();
+             interior.push_back(vit);
+           }
+        auto surface_displacement = [&](const Point_3& p)
+        {
+           auto closest = tree.closest_point_and_primitive(p);
+           std::size_t t = closest.second - triangles.cbegin();
+           std::size_t i = triangle_corners[t].first;
+           std::array<double,3> weights = barycentric_coordinates(triangles[t], closest.first);
+           Kernel::Vector_3 moved(0, 0, 0);
+           for(int j = 0; j < 3; ++j)
+              moved = moved + weights[j]*(points[i][triangle_corners[t].second[j]] - CGAL::ORIGIN);
+           return moved - (closest.first - CGAL::ORIGIN);
+        };
+        std::map<Vertex_handle,Kernel::Vector_3> displacement;
+        for(Vertex_handle vh : boundary)
+           displacement[vh] = surface_displacement(tr.point(vh).point());
+        for(Polylines* polylines : {&this->borders, &this->features})
+           for(auto& polyline : *polylines)
+              for(auto& p : polyline)
+                 p = p + surface_displacement(p);
+
+        // Harmonic extension, i.e. the graph Laplace equation with the boundary displacement as Dirichlet condition.
+        Eigen::MatrixXd solution = Eigen::MatrixXd::Zero(interior.size(), 3);
+        if( !interior.empty() )
+        {
+          ScopedTimer timer("Domain::harmonic_extension");
+          std::vector<Eigen::Triplet<double>> triplets;
+          Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(interior.size(), 3);
+          for(auto eit = tr.finite_edges_begin(); eit != tr.finite_edges_end(); ++eit)
+          {
+             Vertex_handle a = eit->first->vertex(eit->second);
+             Vertex_handle b = eit->first->vertex(eit->third);
+             for(int side = 0; side < 2; ++side)
+             {
+                auto it = unknown.find(a);
+                if( it!=unknown.end() )
+                {
+                  triplets.push_back(Eigen::Triplet<double>(it->second, it->second, 1.0));
+                  auto jt = unknown.find(b);
+                  if( jt!=unknown.end() )
+                    triplets.push_back(Eigen::Triplet<double>(it->second, jt->second, -1.0));
+                  else
+                  {
+                    const Kernel::Vector_3& d = displacement[b];
+                    for(int j = 0; j < 3; ++j)
+                       rhs(it->second, j) += d[j];
+                  }
+                }
+                std::swap(a, b);
+             }
+          }
+          Eigen::SparseMatrix<double> laplacian(interior.size(), interior.size());
+          laplacian.setFromTriplets(triplets.begin(), triplets.end());
+          Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(laplacian);
+          if( solver.info()!=Eigen::Success )
+            throw AlgorithmError("The factorization of the harmonic extension failed.");
+          solution = solver.solve(rhs);
+          if( solver.info()!=Eigen::Success )
+            throw AlgorithmError("The harmonic extension could not be solved.");
+        }
+        for(auto const& moved : displacement)
+           moved.first->set_point(Weighted_point(tr.point(moved.first).point() + moved.second, tr.point(moved.first).weight()));
+        for(std::size_t i = 0; i < interior.size(); ++i)
+           interior[i]->set_point(Weighted_point(tr.point(interior[i]).point() + Kernel::Vector_3(solution(i,0), solution(i,1), solution(i,2)), 
+                                                 tr.point(interior[i]).weight()));
+        clear_output_order();
+        triangle_data.clear();
+        point_data.clear();
+
+        // Cells in the complex that are inverted or below the dihedral angle bound.
+        std::set<Cell_handle> region;
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+        {
+           Kernel::Tetrahedron_3 tetrahedron = tr.tetrahedron(cit);
+           if( tetrahedron.orientation()!=CGAL::POSITIVE or 
+               static_cast<double>(CGAL::Mesh_3::minimum_dihedral_angle(tetrahedron, Kernel()))<min_dihedral_angle )
+             region.insert(cit);
+        }
+        int bad_cells = region.size();
+        if( bad_cells==0 )
+        {
+          reference_points.swap(points);
+          number_of_input_surfaces = surfaces.size();
+          clear_meshing_inputs();
+          finalized = true;
+          regular = false;
+          return 0;
+        }
+
+        for(int layer = 0; layer < buffer_layers; ++layer)
+        {
+           std::set<Vertex_handle> layer_vertices;
+           for(Cell_handle c : region)
+              for(int i = 0; i < 4; ++i)
+                 layer_vertices.insert(c->vertex(i));
+           for(Vertex_handle vh : layer_vertices)
+           {
+              std::vector<Cell_handle> cells;
+              tr.finite_incident_cells(vh, std::back_inserter(cells));
+              region.insert(cells.begin(), cells.end());
+           }
+        }
+        std::set<Vertex_handle> removed;
+        CGAL::Bbox_3 bbox;
+        for(Cell_handle c : region)
+        {
+           bbox += tr.tetrahedron(c).bbox();
+           for(int i = 0; i < 4; ++i)
+              if( c->vertex(i)->in_dimension()==3 )
+                removed.insert(c->vertex(i));
+        }
+        rebuild_triangulation(removed);
+
+        clear_meshing_inputs();
+        this->resolution = 0;
+        set_meshing_inputs(surfaces, error_bound);
+        finalized = false;
+        register_features();
+        if( mesh_resolution<=0 )
+          mesh_resolution = this->resolution;
+        double r = min_sphere.get_bounding_sphere_radius(); 
+        refine_existing_mesh(local_resolution_criteria(r, mesh_resolution, dilate(bbox, r/mesh_resolution)));
+        return bad_cells;
+     }
+
+     // DocString: get_slice
+    /** 
+     * @brief Intersects the cells of the mesh with a plane, and returns the sections as a tagged 2D mesh.
+     *
+     * The section of each cell is a triangle or a quadrilateral with the subdomain tag of the cell, and 
+     * the sections are triangulated with the section edges as constraints. The edges between faces with 
+     * different tags get the interface tags of the mesh. Unlike Surface::get_slice, the 2D mesh does not 
+     * need Slice::create_mesh and Slice::add_surface_domains, and can be written with Slice::save.
+     * @tparam Slice SVMTK Slice class.
+     * @param plane the plane of the slice.
+     * @returns a SVMTK Slice object with the tagged 2D mesh.
+     * @throws EmptyMeshError if the mesh is empty.
+     */
+     template<typename Slice>
+     std::shared_ptr<Slice> get_slice(typename Slice::Plane_3 plane)
+     {
+        ScopedTimer timer("Domain::get_slice");
+        assert_non_empty_mesh_object();
+        std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
+        return slice_mesh<Slice>(plane, facet_map);
+     }
+
+     // DocString: get_slice
+    /** 
+     * @brief Intersects the cells of the mesh with a plane defined by the plane equation ax + by + cz + d = 0.
+     * @tparam Slice SVMTK Slice class.
+     * @param a parameter in the plane equation.
+     * @param b parameter in the plane equation.
+     * @param c parameter in the plane equation.
+     * @param d parameter in the plane equation.
+     * @returns a SVMTK Slice object with the tagged 2D mesh.
+     * @throws InvalidArgumentError if the plane parameters are invalid.
+     * @overload
+     */
+     template<typename Slice>
+     std::shared_ptr<Slice> get_slice(double a, double b, double c, double d)
+     {
+        if( a==0 and b==0 and c==0 )
+          throw InvalidArgumentError("Invalid plane parameters.");
+        return get_slice<Slice>(typename Slice::Plane_3(a, b, c, d));
+     }
+
+     // DocString: get_slices
+    /** 
+     * @brief Intersects the cells of the mesh with each plane concurrently, @see get_slice.
+     * @tparam Slice SVMTK Slice class.
+     * @param planes vector of planes, e.g. parallel planes through a stack.
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     * @returns a vector of SVMTK Slice objects in the same order as planes.
+     * @throws EmptyMeshError if the mesh is empty.
+     */
+     template<typename Slice>
+     std::vector<std::shared_ptr<Slice>> get_slices(std::vector<typename Slice::Plane_3> planes, int num_threads=0)
+     {
+        ScopedTimer timer("Domain::get_slices");
+        assert_non_empty_mesh_object();
+        std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
+        std::vector<std::shared_ptr<Slice>> result(planes.size());
+        // The mesh is only read while slicing, and is shared by the threads. 
+        parallel_for(planes.size(), num_threads, [&](std::size_t i)
+        {
+           result[i] = slice_mesh<Slice>(planes[i], facet_map);
+        });
+        return result;
+     }
+
+     // DocString: create_mesh     
+    /** 
+     * @brief Creates the mesh stored in the class member variable c3t3.  
+     *        The mesh resolution is set automatic to the highest mesh resolution of 
+     *        the surface(s).  
+     * @overload
+     */
+     bool create_mesh()
+     {
+         return create_mesh(this->resolution);
+     }
+     
+    // DocString: save   
+    /** 
+     * @brief Writes the mesh stored in the class member variable c3t3 to file.
+     *  
+     * The interface tags are loaded from SubdomainMap added in the constructor. 
+     * If there are no interfaces in SubDomainMap, then default interfaces are 
+     * selected.
+     *
+     * @param outpath the path to the output file.
+     * @param save_1Dfeatures option to save the edges with tags.
+     */
+     void save(std::string outpath,bool save_1Dfeatures)
+     {
+        ScopedTimer timer("Domain::save");
+        assert_non_empty_mesh_object();
+        std::ofstream  medit_file(outpath);
+        typedef CGAL::Mesh_3::Medit_pmap_generator<C3t3,false,false> Generator;
+        typedef Generator::Cell_pmap Cell_pmap;
+        typedef Generator::Facet_pmap Facet_pmap;
+        typedef Generator::Facet_pmap_twice Facet_pmap_twice;
+        typedef Generator::Vertex_pmap Vertex_pmap;
+ 
+        Cell_pmap cell_pmap(c3t3);
+        Facet_pmap facet_pmap(c3t3, cell_pmap); 
+        Facet_pmap_twice  facet_twice_pmap(c3t3,cell_pmap);
+        Vertex_pmap vertex_pmap(c3t3, cell_pmap,facet_pmap); // -> vertex_pmap
+
+        std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
+    
+        std::vector<Vertex_handle> vertex_order;
+        std::vector<Cell_handle> cell_order;
+        output_order(vertex_order, cell_order);
+        output_to_medit_(medit_file, c3t3, vertex_pmap, facet_map, cell_pmap, facet_twice_pmap , false, save_1Dfeatures,
+                         vertex_order, cell_order);
         medit_file.close();
      }
 
+    // DocString: set_output_ordering
+    /**
+     * @brief Sets the numbering of the vertices and cells in the files written with save and 
+     *        save_partitions, and of the cells in partition.
+     *
+     * The option "hilbert" orders the vertices and the cells along a Hilbert curve, and the 
+     * option "rcm" orders the vertices with reverse Cuthill-McKee, and the cells by their vertices.
+     * Both place neighbouring vertices and cells close in memory, which improves the cache 
+     * efficiency of solvers that read the mesh. The facets are written in the same order as before.
+     * The data fields are renumbered accordingly, @see set_data.
+     * @param ordering "none", "hilbert" or "rcm".
+     * @throws InvalidArgumentError if the ordering is unknown.
+     */
+     void set_output_ordering(std::string ordering)
+     {
+        if( ordering!="none" and ordering!="hilbert" and ordering!="rcm" )
+          throw InvalidArgumentError(("Unknown output ordering: " + ordering).c_str());
+        output_ordering = ordering;
+        clear_output_order();
+        update_data();
+     }
+
+    // DocString: get_output_ordering
+    /**
+     * @brief Returns the numbering of the vertices and cells in the output, @see set_output_ordering.
+     * @returns "none", "hilbert" or "rcm".
+     */
+     std::string get_output_ordering() const
+     {
+        return output_ordering;
+     }
+
+    // DocString: partition
+    /**
+     * @brief Partitions the cells of the mesh into parts with balanced number of cells and 
+     *        few facets between the parts, e.g. for distributed solvers.
+     *
+     * The graph of cells connected through facets is partitioned with METIS if SVMTK is built 
+     * with SVMTK_USE_METIS, and otherwise with the bundled multilevel recursive bisection. 
+     * The partition is stored for save_partitions until the mesh is changed.
+     * @param num_parts the number of parts.
+     * @param imbalance the allowed ratio between the number of cells in a part and the average.
+     * @returns the part of each cell, in the order that the cells are written with save.
+     */
+     std::vector<int> partition(int num_parts, double imbalance=1.03)
+     {
+        ScopedTimer timer("Domain::partition");
+        assert_non_empty_mesh_object();
+        std::vector<Vertex_handle> vertex_order;
+        output_order(vertex_order, partition_cells);
+        std::map<Cell_handle,std::size_t> cell_index;
+        for(Cell_handle cit : partition_cells)
+        {
+           std::size_t index = cell_index.size();
+           cell_index[cit] = index;
+        }
+        CSR_graph graph;
+        for(Cell_handle cit : partition_cells)
+        {
+           graph.vertex_weights.push_back(1);
+           for(int i = 0; i < 4; ++i)
+           {
+              auto neighbor = cell_index.find(cit->neighbor(i));
+              if( neighbor==cell_index.end() )
+                continue;
+              graph.adjacency.push_back(neighbor->second);
+              graph.edge_weights.push_back(1);
+           }
+           graph.offsets.push_back(graph.adjacency.size());
+        }
+        cell_partition = partition_graph(graph, num_parts, imbalance);
+        number_of_parts = num_parts;
+        return cell_partition;
+     }
+
+    // DocString: save_partitions
+    /**
+     * @brief Writes each part of the partition to a separate medit file, with optional ghost layers.
+     *
+     * Part p is written to outpath_p.mesh, with outpath stripped of the extension .mesh.
+     * The ghost cells are the cells of other parts that share a vertex with the part, or with the 
+     * previous ghost layer, and are written after the cells of the part. The file outpath_p.map lists 
+     * the vertex number of each vertex, and the cell number and part of each cell, in the mesh written with save.
+     * @param outpath the path to the output files. 
+     * @param ghost_layers the number of ghost layers.
+     * @param save_1Dfeatures option to save the edges with tags.
+     * @throws PreconditionError if the mesh is not partitioned, or changed after partition.
+     */
+     void save_partitions(std::string outpath, int ghost_layers=0, bool save_1Dfeatures=true)
+     {
+        ScopedTimer timer("Domain::save_partitions");
+        assert_non_empty_mesh_object();
+        if( cell_partition.size()!=c3t3.number_of_cells_in_complex() or cell_partition.size()!=partition_cells.size() or number_of_parts==0 )
+          throw PreconditionError("Mesh is not partitioned, or changed after partition.");
+        if( outpath.size()>5 and outpath.substr(outpath.size()-5)==".mesh" )
+          outpath = outpath.substr(0, outpath.size()-5);
+
+        typedef CGAL::Mesh_3::Medit_pmap_generator<C3t3,false,false> Generator;
+        Generator::Cell_pmap cell_pmap(c3t3);
+        Generator::Facet_pmap facet_pmap(c3t3, cell_pmap);
+        Generator::Vertex_pmap vertex_pmap(c3t3, cell_pmap, facet_pmap);
+        std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
+
+        const Tr& tr = c3t3.triangulation();
+        std::vector<Vertex_handle> vertex_order;
+        std::vector<Cell_handle> cell_order;
+        output_order(vertex_order, cell_order);
+        std::map<Vertex_handle,int> vertex_number;
+        for(Vertex_handle vh : vertex_order)
+        {
+           int number = vertex_number.size() + 1;
+           vertex_number[vh] = number;
+        }
+        std::map<Cell_handle,std::size_t> cell_number;
+        for(Cell_handle c : cell_order)
+        {
+           std::size_t number = cell_number.size();
+           cell_number[c] = number;
+        }
+        const std::vector<Cell_handle>& cells = partition_cells;
+        std::map<Cell_handle,int> cell_part;
+        for(std::size_t i = 0; i < cells.size(); ++i)
+           cell_part[cells[i]] = cell_partition[i];
+
+        for(int part = 0; part < number_of_parts; ++part)
+        {
+           std::vector<Cell_handle> selected;
+           std::set<Cell_handle> is_selected;
+           for(std::size_t i = 0; i < cells.size(); ++i)
+              if( cell_partition[i]==part )
+              {
+                selected.push_back(cells[i]);
+                is_selected.insert(cells[i]);
+              }
+           std::size_t layer_begin = 0;
+           std::set<Vertex_handle> visited;
+           for(int layer = 0; layer < ghost_layers; ++layer)
+           {
+              std::size_t layer_end = selected.size();
+              for(std::size_t i = layer_begin; i < layer_end; ++i)
+                 for(int j = 0; j < 4; ++j)
+                 {
+                    Vertex_handle vh = selected[i]->vertex(j);
+                    if( !visited.insert(vh).second )
+                      continue;
+                    std::vector<Cell_handle> incident;
+                    tr.incident_cells(vh, std::back_inserter(incident));
+                    for(Cell_handle c : incident)
+                       if( c3t3.is_in_complex(c) and is_selected.insert(c).second )
+                         selected.push_back(c);
+                 }
+              layer_begin = layer_end;
+           }
+           write_partition(outpath + "_" + std::to_string(part), selected, is_selected, cell_number, vertex_number,
+                           cell_part, vertex_pmap, cell_pmap, facet_map, save_1Dfeatures);
+        }
+     }
+
     // DocString: remove_subdomain
     /**
      * @brief Removes all cells in the mesh with a specified integer tag , but perserves the 
@@ -1086,6 +2364,7 @@ class Domain {
      void remove_subdomain(std::vector<int> tags)
      {
         assert_non_empty_mesh_object();
+        assert_regular_triangulation();
         int before = c3t3.number_of_cells();
         std::vector<std::tuple<Cell_handle,int,int,int>> rebind;  
         int spindex1,spindex2;
@@ -1146,6 +2425,93 @@ class Domain {
 
          std::cout << "Number of removed subdomain cells : " << (before -after) << std::endl;
          c3t3.rescan_after_load_of_triangulation(); 
+         clear_output_order();
+         update_data();
+     }
+
+    // DocString: relabel_subdomains
+    /**
+     * @brief Changes the subdomain tags of the mesh without remeshing.
+     *
+     * The facets between cells that get the same tag are removed from the complex, and the facets 
+     * of the changed cells are given the surface patch index of the new tags. The vertices are not moved.
+     * @param tags map from old subdomain tags to new subdomain tags, tags not in the map are kept.
+     * @returns the number of cells with changed tags.
+     * @throws InvalidArgumentError if a new tag is 0, @see remove_subdomain.
+     * @overload
+     */
+     int relabel_subdomains(std::map<int,int> tags)
+     {
+        ScopedTimer timer("Domain::relabel_subdomains");
+        assert_non_empty_mesh_object();
+        for(auto const& tag : tags)
+           if( tag.second==0 )
+             throw InvalidArgumentError("The new subdomain tags must be non-zero, use remove_subdomain to remove cells.");
+        std::vector<std::pair<Cell_handle,int>> labels;
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+        {
+           auto it = tags.find(static_cast<int>(c3t3.subdomain_index(cit)));
+           if( it!=tags.end() )
+             labels.push_back(std::make_pair(Cell_handle(cit), it->second));
+        }
+        return relabel_cells(labels);
+     }
+
+    /**
+     * @brief Changes the subdomain tags of the mesh without remeshing, by classifying the 
+     *        centroids of the cells with a set of surfaces. 
+     *
+     * The tag of a cell is given by the map of the bitstring of the surfaces that contain the centroid, 
+     * @see Polyhedral_vector_to_labeled_function_wrapper, and cells with tag 0, e.g. outside all surfaces, 
+     * keep their tag. The centroids are classified concurrently. 
+     * @param surfaces a vector of SVMTK Surface objects.
+     * @param map SVMTK SubdomainMap object for the surfaces. 
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     * @returns the number of cells with changed tags.
+     * @overload
+     */
+     template<typename Surface>
+     int relabel_subdomains(std::vector<Surface> surfaces, std::shared_ptr<AbstractMap> map, int num_threads=0)
+     {
+        ScopedTimer timer("Domain::relabel_subdomains");
+        assert_non_empty_mesh_object();
+        Function_vector functions;
+        for(auto& surface : surfaces)
+        {
+           if( !surface.does_bound_a_volume() )
+             surface.fill_holes();
+           Polyhedron polyhedron;
+           surface.get_polyhedron(polyhedron);
+           functions.push_back(new Polyhedral_mesh_domain_3(polyhedron));
+           counters->increment(QueryCounters::AABB_TREE_CONSTRUCTIONS);
+        }
+        Function_wrapper wrapper(functions, map, counters);
+
+        const Tr& tr = c3t3.triangulation();
+        std::vector<Cell_handle> cells;
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+           cells.push_back(cit);
+        std::vector<int> tags(cells.size(), 0);
+        const std::size_t chunk = 1024;
+
+        // The surfaces and the map are only read by the threads.
+        parallel_for((cells.size() + chunk - 1)/chunk, num_threads, [&](std::size_t k)
+        {
+           for(std::size_t i = k*chunk; i < std::min((k+1)*chunk, cells.size()); ++i)
+           {
+              Cell_handle c = cells[i];
+              tags[i] = wrapper(CGAL::centroid(tr.point(c->vertex(0)).point(), tr.point(c->vertex(1)).point(),
+                                               tr.point(c->vertex(2)).point(), tr.point(c->vertex(3)).point()));
+           }
+        });
+        for(auto function : functions)
+           delete function;
+
+        std::vector<std::pair<Cell_handle,int>> labels;
+        for(std::size_t i = 0; i < cells.size(); ++i)
+           if( tags[i]!=0 )
+             labels.push_back(std::make_pair(cells[i], tags[i]));
+        return relabel_cells(labels);
      }
 
     /**
@@ -1167,31 +2533,13 @@ class Domain {
         EIF_map eif = get(CGAL::edge_is_feature, polyhedron);
         CGAL::Polygon_mesh_processing::detect_sharp_edges(polyhedron,threshold, eif); 
 
-        Point_3  p1,p2;
-        Polylines temp;
-        bool intersecting=false;
+        std::vector<Segment_3> segments;
         for(boost::graph_traits<Polyhedron>::edge_descriptor e : edges(polyhedron))
         {
            if( get(eif, e) )
-           {
-             Polyline_3 polyline;
-             p1 = source(e,polyhedron)->point();
-             p2 = target(e,polyhedron)->point();
-             polyline={p1,p2};
-             intersecting=false;
-             for(auto pline : this->borders) 
-             {
-                if( CGAL::Polygon_mesh_processing::do_intersect(polyline,pline)) 
-                  intersecting=true;      
-             } 
-             if( !intersecting )
-               temp.push_back(polyline);
-          }
-       }
-       if( temp.size()==0 )
-         std::cout <<"Warning, new edges intersects with existing edges."<<std::endl;
-       else
-         this->borders.insert(this->borders.end(), temp.begin(), temp.end());     
+             segments.push_back(Segment_3(source(e,polyhedron)->point(), target(e,polyhedron)->point()));
+        }
+        add_nonintersecting_borders(segments);
      }
 
 
@@ -1216,36 +2564,58 @@ class Domain {
         CGAL::Polygon_mesh_processing::detect_sharp_edges(polyhedron,threshold, eif); 
 
         Point_3  p1,p2;
-        Polylines temp;
-        bool intersecting=false;
+        std::vector<Segment_3> segments;
         for(boost::graph_traits<Polyhedron>::edge_descriptor e : edges(polyhedron))
         {
            if( get(eif, e) )
            {
-             Polyline_3 polyline;
              p1 = source(e,polyhedron)->point();
              p2 = target(e,polyhedron)->point();
-
-             if( CGAL::squared_distance(plane,p1)< FT(error) && CGAL::squared_distance(plane,p1)<FT(error) )
-             {
-                polyline={p1,p2};
-                intersecting=false;
-                for(auto pline : this->borders) 
-                {
-                   if( CGAL::Polygon_mesh_processing::do_intersect(polyline,pline) ) 
-                   {
-                     intersecting=true; 
-                   }       
-                } 
-                if( !intersecting )
-                  temp.push_back(polyline);
-             }
+             if( CGAL::squared_distance(plane,p1)< FT(error) && CGAL::squared_distance(plane,p2)<FT(error) )
+               segments.push_back(Segment_3(p1,p2));
           }
        }
-       if( temp.size()==0 )
-         std::cout <<"Warning, new edges intersects with existing edges."<<std::endl;
-       else
-         this->borders.insert(this->borders.end(), temp.begin(), temp.end());     
+       add_nonintersecting_borders(segments);
+     }
+
+    /**
+     * @brief Adds the segments that do not intersect the existing borders to this->borders.
+     *
+     * The segments of the existing borders are stored in an AABB tree, and the segments are 
+     * queried concurrently, so that the conflict checks are O((E+B)log B) instead of O(E*B) 
+     * for E segments and B border segments. The segments are not checked against each other.
+     * @param segments the candidate segments, e.g. sharp edges.
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     */
+     void add_nonintersecting_borders(const std::vector<Segment_3>& segments, int num_threads=0)
+     {
+        ScopedTimer timer("Domain::add_nonintersecting_borders");
+        typedef std::vector<Segment_3>::const_iterator Segment_iterator;
+        typedef CGAL::AABB_segment_primitive<Kernel, Segment_iterator> Primitive;
+        typedef CGAL::AABB_tree<CGAL::AABB_traits<Kernel, Primitive>> Tree;
+        std::vector<Segment_3> border_segments;
+        for(auto const& polyline : this->borders)
+           for(std::size_t i = 0; i+1 < polyline.size(); ++i)
+              border_segments.push_back(Segment_3(polyline[i], polyline[i+1]));
+        std::vector<char> is_intersecting(segments.size(), 0);
+        if( !border_segments.empty() and !segments.empty() )
+        {
+          Tree tree(border_segments.begin(), border_segments.end());
+          tree.build();
+          // The tree is only read by the queries, and is shared by the threads.
+          parallel_for(segments.size(), num_threads, [&](std::size_t i)
+          {
+             is_intersecting[i] = tree.do_intersect(segments[i]);
+          });
+        }
+        Polylines temp;
+        for(std::size_t i = 0; i < segments.size(); ++i)
+           if( !is_intersecting[i] )
+             temp.push_back(Polyline_3{segments[i].source(), segments[i].target()});
+        if( temp.size()==0 )
+          std::cout <<"Warning, new edges intersects with existing edges."<<std::endl;
+        else
+          this->borders.insert(this->borders.end(), temp.begin(), temp.end());     
      }
 
     // DocString: add_sharp_border_edges     
@@ -1409,6 +2779,23 @@ class Domain {
         return surf;
      }
     
+    /**
+     * @brief Restricts the time limit of a CGAL optimizer to the budget of the active CancellationToken.
+     * @param[in,out] time_limit CGAL time limit, where 0 means no limit. 
+     * @returns false if the active CancellationToken is already cancelled.
+     */
+     bool apply_time_budget(double& time_limit)
+     {
+        CancellationToken* token = CancellationToken::current();
+        if( !token )
+          return true;
+        if( token->is_cancelled() )
+          return false;
+        if( token->has_time_budget() and ( time_limit<=0 or time_limit>token->remaining_time() ) )
+          time_limit = token->remaining_time();
+        return true;
+     }
+
     // DocString: lloyd
     /**
      * @brief CGAL function for lloyd  optimization of the constructed mesh.   
@@ -1420,16 +2807,23 @@ class Domain {
      * @param convergence the displacement of any vertex is less than a given percentage of the length of the shortest edge incident to that vertex.
      * @param freeze_bound vertex that has a displacement less than a given percentage of the length (the of its shortest incident edge, is frozen (i.e. is not relocated).
      * @param do_freeze completes the freeze_bound paramet
+     * @returns false if stopped by the active CancellationToken, otherwise true.
      */
-     void lloyd(double time_limit, int max_iteration_number, double convergence,double freeze_bound, bool do_freeze)
+     bool lloyd(double time_limit, int max_iteration_number, double convergence,double freeze_bound, bool do_freeze)
      {   
+        ScopedTimer timer("Domain::lloyd");
         assert_non_empty_mesh_object();
+        assert_meshing_inputs();
+        if( !apply_time_budget(time_limit) )
+          return false;
+        clear_mesh_data();
         CGAL::lloyd_optimize_mesh_3(c3t3, *domain_ptr.get(), 
                                           time_limit=time_limit, 
                                           max_iteration_number= max_iteration_number,
                                           convergence= convergence, 
                                           freeze_bound= freeze_bound, 
                                           do_freeze= do_freeze); 
+        return !cancellation_requested();
      } 
 
     // DocString: odt
@@ -1442,16 +2836,23 @@ class Domain {
      * @param convergence the displacement of any vertex is less than a given percentage of the length of the shortest edge incident to that vertex.
      * @param freeze_bound vertex that has a displacement less than a given percentage of the length (the of its shortest incident edge, is frozen (i.e. is not relocated).
      * @param do_freeze completes the freeze_bound paramet
+     * @returns false if stopped by the active CancellationToken, otherwise true.
      */
-     void odt(double time_limit, int max_iteration_number, double convergence,double freeze_bound, bool do_freeze) 
+     bool odt(double time_limit, int max_iteration_number, double convergence,double freeze_bound, bool do_freeze) 
      {    
+        ScopedTimer timer("Domain::odt");
         assert_non_empty_mesh_object();
+        assert_meshing_inputs();
+        if( !apply_time_budget(time_limit) )
+          return false;
+        clear_mesh_data();
         CGAL::odt_optimize_mesh_3(c3t3, *domain_ptr.get(), 
                                         time_limit=time_limit,
                                         max_iteration_number= max_iteration_number,
                                         convergence= convergence, 
                                         freeze_bound= freeze_bound,
                                         do_freeze= do_freeze); 
+        return !cancellation_requested();
      } 
 
     // DocString: excude
@@ -1460,12 +2861,20 @@ class Domain {
      * @see  (excude_optimize_mesh)[https://doc.cgal.org/latest/Mesh_3/group__PkgMesh3Functions.html]
      * @param time_limit used to set up, in seconds, a CPU time limit after which the optimization process is stopped. 
      * @param sliver_bound a targeted lower bound on dihedral angles of mesh cells.
+     * @returns false if stopped by the active CancellationToken, otherwise true.
+     * @throws PreconditionError if the mesh is not a regular triangulation, @see is_regular().
      */
-     void exude(double time_limit= 0, double sliver_bound= 0)
+     bool exude(double time_limit= 0, double sliver_bound= 0)
      { 
+        ScopedTimer timer("Domain::exude");
         assert_non_empty_mesh_object(); 
+        assert_regular_triangulation();
+        if( !apply_time_budget(time_limit) )
+          return false;
+        clear_mesh_data();
         CGAL::exude_mesh_3(c3t3, sliver_bound= sliver_bound, 
                                  time_limit= time_limit);
+        return !cancellation_requested();
      } 
    
     // DocString: perturb   
@@ -1474,15 +2883,93 @@ class Domain {
      * @see (perturb_mesh)[https://doc.cgal.org/latest/Mesh_3/group__PkgMesh3Functions.html]
      * @param time_limit used to set up, in seconds, a CPU time limit after which the optimization process is stopped. 
      * @param sliver_bound a targeted lower bound on dihedral angles of mesh cells.
+     * @returns false if stopped by the active CancellationToken, otherwise true.
      */
-     void perturb(double time_limit= 0, double sliver_bound= 0)
+     bool perturb(double time_limit= 0, double sliver_bound= 0)
      {    
-        assert_non_empty_mesh_object(); 
+        ScopedTimer timer("Domain::perturb");
+        assert_non_empty_mesh_object();
+        assert_meshing_inputs(); 
+        if( !apply_time_budget(time_limit) )
+          return false;
+        clear_mesh_data();
         CGAL::perturb_mesh_3(c3t3, *domain_ptr.get(), time_limit= time_limit, 
                                                       sliver_bound= sliver_bound);
+        return !cancellation_requested();
      } 
 
-     // DocString: check_mesh_connections  
+    // DocString: optimize
+    /**
+     * @brief Runs the mesh optimizers until the mesh quality targets are met or the time budget is spent.
+     *
+     * The optimizers are run in the order odt, lloyd, perturb and exude, where lloyd is only run if odt did not 
+     * improve the minimum radius ratio, and exude is the only optimizer after finalize(). Exude is skipped 
+     * if the mesh is not a regular triangulation, @see is_regular(). The mesh quality is 
+     * measured after each pass, and the optimization stops as soon as both targets are met. The time budget 
+     * is split among the remaining optimizers, so that the time not used by a pass goes to the next passes.
+     * The target dihedral angle is used as the sliver bound of perturb and exude.
+     * @param min_dihedral_angle the target minimum dihedral angle in degrees.
+     * @param min_radius_ratio the target minimum radius ratio.
+     * @param time_budget the total time budget in seconds.
+     * @returns the passes that were run, with the mesh quality before and after each pass.
+     */
+     std::vector<OptimizationPass> optimize(double min_dihedral_angle=10., double min_radius_ratio=0.1, double time_budget=60.)
+     {
+        ScopedTimer timer("Domain::optimize");
+        assert_non_empty_mesh_object();
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        std::vector<std::pair<std::string,double>> schedule;
+        if( !finalized )
+          schedule = {{"odt", 0.35}, {"lloyd", 0.15}, {"perturb", 0.25}};
+        if( regular )
+          schedule.push_back({"exude", 0.25});
+
+        std::vector<OptimizationPass> passes;
+        std::pair<double,double> angles = dihedral_angles_min_max();
+        std::pair<double,double> ratios = radius_ratios_min_max();
+        for(std::size_t i = 0; i < schedule.size(); ++i)
+        {
+           if( angles.first>=min_dihedral_angle and ratios.first>=min_radius_ratio )
+             break;
+           const std::string& optimizer = schedule[i].first;
+           if( optimizer=="lloyd" and !passes.empty() and passes.back().min_radius_ratio_after>1.01*passes.back().min_radius_ratio_before )
+             continue;
+           double remaining = time_budget - std::chrono::duration<double>(Clock::now()-start).count();
+           if( remaining<=0 )
+             break;
+           double shares = 0;
+           for(std::size_t j = i; j < schedule.size(); ++j)
+              shares += schedule[j].second;
+
+           OptimizationPass pass;
+           pass.optimizer = optimizer;
+           pass.time_limit = remaining*schedule[i].second/shares;
+           pass.min_dihedral_angle_before = angles.first;
+           pass.min_radius_ratio_before = ratios.first;
+           Clock::time_point pass_start = Clock::now();
+           if( optimizer=="odt" )
+             pass.completed = odt(pass.time_limit, 0, 0.02, 0.01, true);
+           else if( optimizer=="lloyd" )
+             pass.completed = lloyd(pass.time_limit, 0, 0.02, 0.01, true);
+           else if( optimizer=="perturb" )
+             pass.completed = perturb(pass.time_limit, min_dihedral_angle);
+           else
+             pass.completed = exude(pass.time_limit, min_dihedral_angle);
+           pass.seconds = std::chrono::duration<double>(Clock::now()-pass_start).count();
+           angles = dihedral_angles_min_max();
+           ratios = radius_ratios_min_max();
+           pass.min_dihedral_angle_after = angles.first;
+           pass.min_radius_ratio_after = ratios.first;
+           passes.push_back(pass);
+           if( !pass.completed )
+             break;
+        }
+        return passes;
+     }
+
+     // DocString: check_mesh_connections  
     /**
      * @brief Checks the connections in the mesh for bad vertices and bad edges,
      *         and prints out the number of bad vertices and bad edges.
@@ -1607,7 +3094,8 @@ class Domain {
      * 
      * @note : We do not use the facets as identifier, since options like remove subdomains will cause 
      *         problems with pointers and addresses. Thus, the data is identified as Trinagle_3, which can be 
-     *         used to find the the matching Facet.
+     *         used to find the the matching Facet. The matched distances are stored in the facet data 
+     *         field "collision_distance", @see set_data.
      *       
      * @param subdomain_tag 
      * @param boundary_tag 
@@ -1624,7 +3112,20 @@ class Domain {
         surf = this->get_boundary<Surface>(subdomain_tag);
         
         this->triangle_data = surf.get()->get_facet_collision_distance(isurf);        
-           
+
+        std::map<Facet,double> facet_data;
+        for(auto const& data : get_facet_data())
+           facet_data[canonical_facet(data.first)] = data.second;
+        std::vector<Facet> facets;
+        output_facets(facets);
+        std::vector<double> values(facets.size(), 0.0);
+        for(std::size_t i = 0; i < facets.size(); ++i)
+        {
+           auto it = facet_data.find(facets[i]);
+           if( it!=facet_data.end() )
+             values[i] = it->second;
+        }
+        set_data("collision_distance", "facet", values);
     }   
 
    // DocString: get_facet_data
@@ -1669,54 +3170,1973 @@ class Domain {
 
    // DocString: write_facet_data
    /**
-    * @brief Writes facet data of the mesh to file 
+    * @brief Writes a facet data field to file, with one line per facet in the order of the 
+    *        Triangles section written with save.
     * 
-    * @param filename
-    * @returns none 
+    * Facets without data, or all facets if the field does not exist, are written as zero.
+    * @param filename the path to the output file.
+    * @param name the name of the facet data field, @see set_data.
     */     
-
-    void write_facet_data(std::string filename) 
+    void write_facet_data(std::string filename, std::string name="collision_distance") 
     {  
-        const Tr& tr = c3t3.triangulation();
-        boost::unordered_map<Facet,double> facet_data = this->get_facet_data();
+        ScopedTimer timer("Domain::write_facet_data");
+        update_data();
         std::ofstream  os(filename);
         os << std::setprecision(17);
+        auto field = data_fields.find(name);
+        bool has_field = field!=data_fields.end() and field->second.entity=="facet";
+        std::size_t number_of_triangles = has_field ? data_facets.size() : number_of_data_entities("facet");
+        int components = has_field ? field->second.components : 1;
 
-        int number_of_triangles=0;
-        for( auto fit = tr.finite_facets_begin(); fit != tr.finite_facets_end(); ++fit)  
+        os << "Triangles\n" << number_of_triangles << '\n';
+        for(std::size_t i = 0; i < number_of_triangles; ++i)
         {
-            if( c3t3.is_in_complex(fit->first) or c3t3.is_in_complex(fit->first->neighbor(fit->second)) ) 
-                number_of_triangles++;
+           for(int j = 0; j < components; ++j)
+              os << (j>0 ? " " : "") << (has_field ? field->second.values[i*components+j] : 0.0);
+           os << '\n';
         }
+    }
 
-        os << "Triangles\n" << number_of_triangles << '\n';
-        for( auto fit = tr.finite_facets_begin(); fit != tr.finite_facets_end(); ++fit)
+   // DocString: number_of_data_entities
+   /**
+    * @brief Returns the number of entities of a data field type, i.e. the number of vertices, cells, 
+    *        or facets written with save.
+    * @param entity "vertex", "facet" or "cell".
+    * @returns the number of entities.
+    * @throws InvalidArgumentError if the entity is unknown.
+    */
+    std::size_t number_of_data_entities(std::string entity)
+    {
+       assert_data_entity(entity);
+       if( entity=="vertex" )
+         return c3t3.triangulation().number_of_vertices();
+       if( entity=="cell" )
+         return c3t3.number_of_cells_in_complex();
+       std::vector<Facet> facets;
+       output_facets(facets);
+       return facets.size();
+    }
+
+   // DocString: set_data
+   /**
+    * @brief Attaches a data field to the vertices, facets or cells of the mesh.
+    *
+    * The values are stored in a contiguous array, with the components of each entity stored 
+    * consecutively, and the entities in the order that they are written with save, i.e. the 
+    * vertices and cells in the output ordering and the facets in the order of the Triangles section. 
+    * The fields are kept through remove_subdomain and set_output_ordering, and are removed when
+    * the mesh is changed by create_mesh or the mesh optimizers.
+    * @param name the name of the field, replaces an existing field with the same name.
+    * @param entity "vertex", "facet" or "cell".
+    * @param values the values of the field.
+    * @param components the number of components per entity.
+    * @throws InvalidArgumentError if the entity is unknown, or the number of values does not match.
+    */
+    void set_data(std::string name, std::string entity, std::vector<double> values, int components=1)
+    {
+       assert_non_empty_mesh_object();
+       assert_data_entity(entity);
+       if( data_fields.empty() )
+       {
+         output_order(data_vertices, data_cells);
+         output_facets(data_facets);
+       }
+       else
+         update_data();
+       std::size_t size = entity=="vertex" ? data_vertices.size() : ( entity=="cell" ? data_cells.size() : data_facets.size() );
+       if( components<1 or values.size()!=size*components )
+         throw InvalidArgumentError(("Expected " + std::to_string(size) + " " + entity + " values with " 
+                                     + std::to_string(components) + " components.").c_str());
+       Data_field& field = data_fields[name];
+       field.entity = entity;
+       field.components = components;
+       field.values.swap(values);
+    }
+
+   // DocString: get_data
+   /**
+    * @brief Returns the values of a data field, @see set_data.
+    * @param name the name of the field.
+    * @returns the values with the components of each entity stored consecutively.
+    * @throws InvalidArgumentError if the field does not exist.
+    */
+    std::vector<double> get_data(std::string name)
+    {
+       update_data();
+       return get_data_field(name).values;
+    }
+
+   // DocString: get_data_components
+   /**
+    * @brief Returns the number of components per entity of a data field.
+    * @param name the name of the field.
+    * @returns the number of components.
+    * @throws InvalidArgumentError if the field does not exist.
+    */
+    int get_data_components(std::string name)
+    {
+       return get_data_field(name).components;
+    }
+
+   // DocString: get_data_entity
+   /**
+    * @brief Returns the entity type of a data field.
+    * @param name the name of the field.
+    * @returns "vertex", "facet" or "cell".
+    * @throws InvalidArgumentError if the field does not exist.
+    */
+    std::string get_data_entity(std::string name)
+    {
+       return get_data_field(name).entity;
+    }
+
+   // DocString: get_data_names
+   /**
+    * @brief Returns the names of the data fields.
+    * @returns a vector of names.
+    */
+    std::vector<std::string> get_data_names() const
+    {
+       std::vector<std::string> names;
+       for(auto const& field : data_fields)
+          names.push_back(field.first);
+       return names;
+    }
+
+   // DocString: remove_data
+   /**
+    * @brief Removes a data field, if it exists.
+    * @param name the name of the field.
+    */
+    void remove_data(std::string name)
+    {
+       data_fields.erase(name);
+       if( data_fields.empty() )
+         clear_data();
+    }
+
+   // DocString: save_xdmf
+   /**
+    * @brief Writes the mesh and the data fields in the XDMF format, with the arrays in a binary file.
+    *
+    * The file outpath.xdmf describes two grids, the tetrahedra with the subdomain tags and the cell and 
+    * vertex data, and the triangles written with save, with the interface tags and the facet data. 
+    * The arrays are written to outpath.bin in native byte order, which is read by e.g. ParaView and meshio.
+    * @param outpath the path to the output files, with or without the extension .xdmf.
+    */
+    void save_xdmf(std::string outpath)
+    {
+       ScopedTimer timer("Domain::save_xdmf");
+       assert_non_empty_mesh_object();
+       if( outpath.size()>5 and outpath.substr(outpath.size()-5)==".xdmf" )
+         outpath = outpath.substr(0, outpath.size()-5);
+       std::string binary_name = outpath.substr(outpath.find_last_of("/\\")==std::string::npos ? 0 : outpath.find_last_of("/\\")+1) + ".bin";
+       update_data();
+
+       typedef CGAL::Mesh_3::Medit_pmap_generator<C3t3,false,false> Generator;
+       Generator::Cell_pmap cell_pmap(c3t3);
+       std::map<std::pair<int,int>,int> facet_map = this->map_ptr->make_interfaces(this->get_patches());
+       const Tr& tr = c3t3.triangulation();
+
+       std::vector<Vertex_handle> vertices;
+       std::vector<Cell_handle> cells;
+       std::vector<Facet> facets;
+       output_order(vertices, cells);
+       output_facets(facets);
+
+       std::map<Vertex_handle,std::int64_t> V;
+       std::vector<double> points;
+       for(Vertex_handle vh : vertices)
+       {
+          std::int64_t index = V.size();
+          V[vh] = index;
+          Weighted_point p = tr.point(vh);
+          points.push_back(CGAL::to_double(p.x()));
+          points.push_back(CGAL::to_double(p.y()));
+          points.push_back(CGAL::to_double(p.z()));
+       }
+       std::vector<std::int64_t> tetrahedra;
+       std::vector<std::int32_t> subdomains;
+       for(Cell_handle c : cells)
+       {
+          for(int i = 0; i < 4; ++i)
+             tetrahedra.push_back(V[c->vertex(i)]);
+          subdomains.push_back(get(cell_pmap, c));
+       }
+       std::vector<std::int64_t> triangles;
+       std::vector<std::int32_t> boundaries;
+       for(Facet f : facets)
+       {
+          Surface_patch_index spi = c3t3.surface_patch_index(f);
+          if( f.first->subdomain_index()>f.first->neighbor(f.second)->subdomain_index() )
+            f = tr.mirror_facet(f);
+          Vertex_handle vh1 = f.first->vertex((f.second + 1) % 4);
+          Vertex_handle vh2 = f.first->vertex((f.second + 2) % 4);
+          Vertex_handle vh3 = f.first->vertex((f.second + 3) % 4);
+          if( f.second%2!=0 )
+            std::swap(vh2, vh3);
+          triangles.push_back(V[vh1]);
+          triangles.push_back(V[vh2]);
+          triangles.push_back(V[vh3]);
+          std::pair<int,int> key(static_cast<int>(spi.first), static_cast<int>(spi.second));
+          if( key.second>key.first )
+            std::swap(key.first,key.second);
+          boundaries.push_back(facet_map.find(key)==facet_map.end() ? 0 : facet_map.at(key));
+       }
+
+       std::ofstream binary(outpath + ".bin", std::ios::binary);
+       std::ofstream xdmf(outpath + ".xdmf");
+       auto data_item = [&](const char* type, int precision, std::size_t rows, int columns, std::size_t seek)
+       {
+          xdmf << "        <DataItem Format=\"Binary\" Endian=\"Native\" NumberType=\"" << type << "\" Precision=\"" << precision
+               << "\" Dimensions=\"" << rows;
+          if( columns>1 )
+            xdmf << " " << columns;
+          xdmf << "\" Seek=\"" << seek << "\">" << binary_name << "</DataItem>\n";
+       };
+       auto attribute = [&](const std::string& name, const char* center, const char* type, int precision, std::size_t rows, int columns, std::size_t seek)
+       {
+          const char* kind = columns==1 ? "Scalar" : ( columns==3 ? "Vector" : "Matrix" );
+          xdmf << "      <Attribute Name=\"" << name << "\" AttributeType=\"" << kind << "\" Center=\"" << center << "\">\n";
+          data_item(type, precision, rows, columns, seek);
+          xdmf << "      </Attribute>\n";
+       };
+
+       std::size_t points_seek = write_binary(binary, points);
+       std::size_t tetrahedra_seek = write_binary(binary, tetrahedra);
+       std::size_t subdomains_seek = write_binary(binary, subdomains);
+       std::size_t triangles_seek = write_binary(binary, triangles);
+       std::size_t boundaries_seek = write_binary(binary, boundaries);
+       std::map<std::string,std::size_t> field_seek;
+       for(auto const& field : data_fields)
+          field_seek[field.first] = write_binary(binary, field.second.values);
+       binary.close();
+
+       xdmf << "<?xml version=\"1.0\"?>\n<Xdmf Version=\"3.0\">\n  <Domain>\n";
+       xdmf << "    <Grid Name=\"mesh\" GridType=\"Uniform\">\n"
+            << "      <Topology TopologyType=\"Tetrahedron\" NumberOfElements=\"" << cells.size() << "\">\n";
+       data_item("Int", 8, cells.size(), 4, tetrahedra_seek);
+       xdmf << "      </Topology>\n      <Geometry GeometryType=\"XYZ\">\n";
+       data_item("Float", 8, vertices.size(), 3, points_seek);
+       xdmf << "      </Geometry>\n";
+       attribute("subdomains", "Cell", "Int", 4, cells.size(), 1, subdomains_seek);
+       for(auto const& field : data_fields)
+       {
+          if( field.second.entity=="cell" )
+            attribute(field.first, "Cell", "Float", 8, cells.size(), field.second.components, field_seek[field.first]);
+          else if( field.second.entity=="vertex" )
+            attribute(field.first, "Node", "Float", 8, vertices.size(), field.second.components, field_seek[field.first]);
+       }
+       xdmf << "    </Grid>\n";
+       xdmf << "    <Grid Name=\"facets\" GridType=\"Uniform\">\n"
+            << "      <Topology TopologyType=\"Triangle\" NumberOfElements=\"" << facets.size() << "\">\n";
+       data_item("Int", 8, facets.size(), 3, triangles_seek);
+       xdmf << "      </Topology>\n      <Geometry GeometryType=\"XYZ\">\n";
+       data_item("Float", 8, vertices.size(), 3, points_seek);
+       xdmf << "      </Geometry>\n";
+       attribute("boundaries", "Cell", "Int", 4, facets.size(), 1, boundaries_seek);
+       for(auto const& field : data_fields)
+          if( field.second.entity=="facet" )
+            attribute(field.first, "Cell", "Float", 8, facets.size(), field.second.components, field_seek[field.first]);
+       xdmf << "    </Grid>\n  </Domain>\n</Xdmf>\n";
+       xdmf.close();
+    }
+
+   private :  
+    /**
+     * \struct Region_of_interest
+     * The region that restricts the labeling, with the distance to its boundary and its bounding box.
+     */
+     struct Region_of_interest
+     {
+        std::function<bool(const Point_3&)> is_inside;
+        std::function<double(const Point_3&)> distance;
+        CGAL::Bbox_3 bbox;
+        Polylines cuts;
+     };
+
+    /**
+     * \struct Cluster
+     * A group of surfaces and 1D features that is meshed separately, with its bounding box.
+     */
+     struct Cluster
+     {
+        std::vector<std::size_t> surfaces;
+        Polylines borders;
+        Polylines features;
+        CGAL::Bbox_3 bbox;
+     };
+
+    /**
+     * \struct Data_field
+     * The values of a data field, with the components of each entity stored consecutively.
+     */
+     struct Data_field
+     {
+        std::string entity;
+        int components;
+        std::vector<double> values;
+     };
+
+    /**
+     * @brief Constructs the polyhedral mesh domains of the surfaces and the labeled mesh domain with the subdomain map.
+     * @param surfaces a vector of SVMTK Surface objects, where surfaces that do not bound a volume are filled.
+     * @param error_bound allowed error of the surface representation.
+     */
+     template<typename Surface>
+     void set_meshing_inputs(std::vector<Surface>& surfaces, double error_bound)
+     {
+        std::vector<std::vector<Point_3>>().swap(reference_points);
+        std::vector<std::vector<Face>>().swap(reference_faces);
+        for(typename std::vector<Surface>::iterator sit=surfaces.begin(); sit!= surfaces.end(); sit++)
+        {
+           if( sit->get_mesh_resolution() > this->resolution) 
+              this->resolution = sit->get_mesh_resolution();
+           if( !sit->does_bound_a_volume() )
+              sit->fill_holes();
+           Polyhedron polyhedron;
+           {
+              ScopedTimer phase_timer("Domain::polyhedron_conversion");
+              sit->get_polyhedron(polyhedron);
+           }
+           min_sphere.add_polyhedron(polyhedron);
+           add_reference_surface(polyhedron);
+           polyhedral_domain_bytes += polyhedral_domain_memory_usage(polyhedron);
+           Polyhedral_mesh_domain_3 *polyhedral_domain;
+           {
+              ScopedTimer phase_timer("Domain::polyhedral_domain");
+              polyhedral_domain = new Polyhedral_mesh_domain_3(polyhedron);
+           }
+           counters->increment(QueryCounters::AABB_TREE_CONSTRUCTIONS);
+           this->v.push_back(polyhedral_domain);
+        }
+        this->error_bound = error_bound;
+        set_mesh_domain();
+        if( roi )
+          roi->cuts = region_of_interest_cuts(*roi);
+     }
+
+    /**
+     * @brief Sets the region of interest and reconstructs the labeled mesh domain.
+     * @param region the region of interest.
+     * @throws InvalidArgumentError if the region does not overlap the surfaces, and the previous region is kept.
+     */
+     void use_region_of_interest(std::shared_ptr<Region_of_interest> region)
+     {
+        std::shared_ptr<Region_of_interest> previous = roi;
+        roi = region;
+        try
+        {
+           set_mesh_domain();
+        }
+        catch(...)
+        {
+           roi = previous;
+           throw;
+        }
+        region->cuts = region_of_interest_cuts(*region);
+     }
+
+    /**
+     * @brief Computes the curves where the boundary of a region cuts the reference surfaces.
+     *
+     * The crossing of each surface edge with endpoints on different sides of the boundary is found by 
+     * bisection, and the crossings of each triangle are joined, so that the polylines lie on the surfaces.
+     * Closed curves have the same first and last point.
+     * @param region the region of interest.
+     * @returns the cut polylines.
+     */
+     Polylines region_of_interest_cuts(const Region_of_interest& region) const
+     {
+        ScopedTimer timer("Domain::region_of_interest_cuts");
+        typedef std::pair<std::size_t,std::size_t> Edge_key;
+        Polylines result;
+        for(std::size_t i = 0; i < reference_points.size(); ++i)
+        {
+           const std::vector<Point_3>& points = reference_points[i];
+           std::vector<char> inside(points.size());
+           for(std::size_t j = 0; j < points.size(); ++j)
+              inside[j] = region.is_inside(points[j]);
+
+           std::vector<Point_3> crossings;
+           std::map<Edge_key,std::size_t> crossing_number;
+           auto crossing = [&](std::size_t a, std::size_t b)
+           {
+              Edge_key key = std::minmax(a, b);
+              auto it = crossing_number.find(key);
+              if( it!=crossing_number.end() )
+                return it->second;
+              Point_3 in = points[inside[a] ? a : b], out = points[inside[a] ? b : a];
+              for(int k = 0; k < 50; ++k)
+              {
+                 Point_3 middle = CGAL::midpoint(in, out);
+                 if( region.is_inside(middle) )
+                   in = middle;
+                 else
+                   out = middle;
+              }
+              crossing_number[key] = crossings.size();
+              crossings.push_back(CGAL::midpoint(in, out));
+              return crossings.size()-1;
+           };
+
+           std::vector<std::vector<std::size_t>> neighbours;
+           for(const Face& face : reference_faces[i])
+              for(std::size_t k = 1; k+1 < face.size(); ++k)
+              {
+                 std::array<std::size_t,3> t{face[0], face[k], face[k+1]};
+                 std::vector<std::size_t> ends;
+                 for(int j = 0; j < 3; ++j)
+                    if( inside[t[j]]!=inside[t[(j+1)%3]] )
+                      ends.push_back(crossing(t[j], t[(j+1)%3]));
+                 if( ends.size()!=2 )
+                   continue;
+                 neighbours.resize(crossings.size());
+                 neighbours[ends[0]].push_back(ends[1]);
+                 neighbours[ends[1]].push_back(ends[0]);
+              }
+           neighbours.resize(crossings.size());
+
+           // Open curves start at a crossing with one neighbour, and the remaining curves are closed.
+           std::vector<char> visited(crossings.size(), 0);
+           auto trace = [&](std::size_t start)
+           {
+              Polyline_3 polyline{crossings[start]};
+              visited[start] = 1;
+              std::size_t current = start;
+              bool extended = true;
+              while( extended )
+              {
+                 extended = false;
+                 for(std::size_t next : neighbours[current])
+                    if( !visited[next] )
+                    {
+                      visited[next] = 1;
+                      polyline.push_back(crossings[next]);
+                      current = next;
+                      extended = true;
+                      break;
+                    }
+              }
+              if( polyline.size()>2 and std::find(neighbours[current].begin(), neighbours[current].end(), start)!=neighbours[current].end() )
+                polyline.push_back(crossings[start]);
+              if( polyline.size()>1 )
+                result.push_back(polyline);
+           };
+           for(std::size_t j = 0; j < crossings.size(); ++j)
+              if( !visited[j] and neighbours[j].size()==1 )
+                trace(j);
+           for(std::size_t j = 0; j < crossings.size(); ++j)
+              if( !visited[j] )
+                trace(j);
+        }
+        return result;
+     }
+
+    /**
+     * @brief Returns the features with the cuts of the region of interest, i.e. the non-border 
+     *        1D features that are added to the mesh domain.
+     * @returns the features as polylines.
+     */
+     Polylines mesh_features() const
+     {
+        Polylines result = this->features;
+        if( roi )
+          result.insert(result.end(), roi->cuts.begin(), roi->cuts.end());
+        return result;
+     }
+
+    /**
+     * @brief Constructs the labeled mesh domain of the polyhedral mesh domains with the subdomain map,
+     *        restricted to the region of interest if it is set.
+     * @throws InvalidArgumentError if the region of interest does not overlap the surfaces.
+     */
+     void set_mesh_domain()
+     {
+        domain_ptr = make_mesh_domain();
+        features_registered = false;
+     }
+
+    /**
+     * @brief Constructs a labeled mesh domain of the polyhedral mesh domains with the subdomain map,
+     *        restricted to the region of interest if it is set, without 1D features.
+     *
+     * The polyhedral mesh domains are shared by the labeled mesh domains, and are only read by them.
+     * @returns a pointer to the labeled mesh domain. 
+     * @throws InvalidArgumentError if the region of interest does not overlap the surfaces.
+     */
+     std::unique_ptr<Mesh_domain> make_mesh_domain() const
+     {
+        Function_wrapper wrapper(this->v,map_ptr,counters);
+        CGAL::Bbox_3 bbox = wrapper.bbox();
+        if( roi )
+        {
+          wrapper.set_region(roi->is_inside);
+          bbox = clip(bbox, roi->bbox);
+          if( is_empty(bbox) )
+            throw InvalidArgumentError("The region of interest does not overlap the surfaces.");
+        }
+        return std::unique_ptr<Mesh_domain>(new Mesh_domain( Labeled_Mesh_Domain(wrapper,bbox,FT(error_bound)))); 
+     }
+
+    /**
+     * @brief Gives the facets of the cut by the region of interest the surface patch (tag, region_of_interest_patch),
+     *        so that the cut gets its own interface tag. A facet is on the cut if it borders the outside 
+     *        and its vertices are on the boundary of the region.
+     */
+     void mark_region_of_interest_boundary()
+     {
+        if( !roi )
+          return;
+        const Tr& tr = c3t3.triangulation();
+        std::vector<std::pair<Facet,int>> cut;
+        for(Facet_iterator fit = c3t3.facets_in_complex_begin(); fit != c3t3.facets_in_complex_end(); ++fit)
+        {
+           Facet mirror = tr.mirror_facet(*fit);
+           int a = c3t3.is_in_complex(fit->first) ? static_cast<int>(c3t3.subdomain_index(fit->first)) : 0;
+           int b = c3t3.is_in_complex(mirror.first) ? static_cast<int>(c3t3.subdomain_index(mirror.first)) : 0;
+           if( a!=0 and b!=0 )
+             continue;
+           std::array<Point_3,3> points;
+           for(int i = 0; i < 3; ++i)
+              points[i] = tr.point(fit->first->vertex((fit->second+i+1)%4)).point();
+           double edge = std::min({CGAL::squared_distance(points[0], points[1]), CGAL::squared_distance(points[1], points[2]), 
+                                   CGAL::squared_distance(points[2], points[0])});
+           double tolerance = 1.e-3*std::sqrt(edge);
+           if( std::all_of(points.begin(), points.end(), [&](const Point_3& p) { return roi->distance(p)<=tolerance; }) )
+             cut.push_back(std::make_pair(*fit, std::max(a, b)));
+        }
+        for(auto const& facet : cut)
+        {
+           c3t3.remove_from_complex(facet.first);
+           c3t3.add_to_complex(facet.first, Surface_patch_index(facet.second, region_of_interest_patch));
+        }
+     }
+
+    /**
+     * @brief Intersects the cells in the complex with a plane, @see get_slice. 
+     *        The intersection point of an edge is computed from its vertices in handle order, 
+     *        so that the cells sharing the edge get the same point. A facet in the plane is only 
+     *        taken from the cell on the negative side of the plane, or from the cell on the positive 
+     *        side if the other cell is not in the complex, so that the section is not added twice.
+     * @tparam Slice SVMTK Slice class.
+     * @param plane the plane of the slice.
+     * @param facet_map the facet tags of each pair of subdomain tags.
+     * @returns a SVMTK Slice object with the tagged 2D mesh.
+     */
+     template<typename Slice>
+     std::shared_ptr<Slice> slice_mesh(const typename Slice::Plane_3& plane, const std::map<std::pair<int,int>,int>& facet_map) const
+     {
+        typedef typename Slice::Point_2 Point_2;
+        const Tr& tr = c3t3.triangulation();
+        std::vector<Point_2> points;
+        std::map<std::pair<Vertex_handle,Vertex_handle>,std::size_t> point_index;
+        std::vector<std::vector<std::size_t>> polygons;
+        std::vector<int> tags;
+        auto add_point = [&](Vertex_handle a, Vertex_handle b)
+        {
+           auto it = point_index.find(std::make_pair(a,b));
+           if( it!=point_index.end() )
+             return it->second;
+           const Point_3& p = tr.point(a).point();
+           Point_3 q = p;
+           if( a!=b )
+           {
+             const Point_3& r = tr.point(b).point();
+             double da = plane.a()*p.x() + plane.b()*p.y() + plane.c()*p.z() + plane.d();
+             double db = plane.a()*r.x() + plane.b()*r.y() + plane.c()*r.z() + plane.d();
+             q = p + (da/(da-db))*(r-p);
+           }
+           point_index[std::make_pair(a,b)] = points.size();
+           points.push_back(plane.to_2d(q));
+           return points.size()-1;
+        };
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+        {
+           std::array<CGAL::Oriented_side,4> side;
+           for(int i = 0; i < 4; ++i)
+              side[i] = plane.oriented_side(tr.point(cit->vertex(i)).point());
+           if( std::all_of(side.begin(), side.end(), [&](CGAL::Oriented_side s) { return s==side[0] and s!=CGAL::ON_ORIENTED_BOUNDARY; }) )
+             continue;
+           if( std::count(side.begin(), side.end(), CGAL::ON_ORIENTED_BOUNDARY)==3 )
+           {
+             int k = std::find_if(side.begin(), side.end(), [](CGAL::Oriented_side s) { return s!=CGAL::ON_ORIENTED_BOUNDARY; }) - side.begin();
+             if( side[k]==CGAL::ON_POSITIVE_SIDE and c3t3.is_in_complex(cit->neighbor(k)) )
+               continue;
+           }
+           std::vector<std::size_t> polygon;
+           for(int i = 0; i < 4; ++i)
+           {
+              if( side[i]==CGAL::ON_ORIENTED_BOUNDARY )
+                polygon.push_back(add_point(cit->vertex(i), cit->vertex(i)));
+              for(int j = i+1; j < 4; ++j)
+                 if( static_cast<int>(side[i])*static_cast<int>(side[j])<0 )
+                   polygon.push_back(add_point(std::min(cit->vertex(i), cit->vertex(j)), std::max(cit->vertex(i), cit->vertex(j))));
+           }
+           if( polygon.size()<3 )
+             continue;
+           double x = 0, y = 0;
+           for(std::size_t i : polygon)
+           {
+              x += points[i].x();
+              y += points[i].y();
+           }
+           x /= polygon.size();
+           y /= polygon.size();
+           std::sort(polygon.begin(), polygon.end(), [&](std::size_t i, std::size_t j) 
+           { 
+              return std::atan2(points[i].y()-y, points[i].x()-x) < std::atan2(points[j].y()-y, points[j].x()-x); 
+           });
+           polygons.push_back(polygon);
+           tags.push_back(static_cast<int>(c3t3.subdomain_index(cit)));
+        }
+        std::shared_ptr<Slice> slice(new Slice(plane));
+        if( !polygons.empty() )
+          slice->set_mesh(points, polygons, tags, facet_map);
+        return slice;
+     }
+
+    /**
+     * @brief Returns the parameters of the closest points of two segments p(s) = p1 + s(q1-p1) and p(t) = p2 + t(q2-p2).
+     * @param p1 the source of the first segment.
+     * @param q1 the target of the first segment.
+     * @param p2 the source of the second segment.
+     * @param q2 the target of the second segment.
+     * @returns the parameters s and t in [0,1].
+     */
+     static std::pair<double,double> closest_segment_parameters(const Point_3& p1, const Point_3& q1, const Point_3& p2, const Point_3& q2)
+     {
+        Kernel::Vector_3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+        double a = d1*d1, e = d2*d2, f = d2*r;
+        if( a<=0 and e<=0 )
+          return std::make_pair(0., 0.);
+        double s = 0, t = 0;
+        if( a<=0 )
+          t = std::min(1., std::max(0., f/e));
+        else
+        {
+          double c = d1*r;
+          if( e<=0 )
+            s = std::min(1., std::max(0., -c/a));
+          else
+          {
+            double b = d1*d2;
+            double denominator = a*e - b*b;
+            s = denominator>0 ? std::min(1., std::max(0., (b*f - c*e)/denominator)) : 0.;
+            t = (b*s + f)/e;
+            if( t<0 )
+            {
+              t = 0;
+              s = std::min(1., std::max(0., -c/a));
+            }
+            else if( t>1 )
+            {
+              t = 1;
+              s = std::min(1., std::max(0., (b - c)/a));
+            }
+          }
+        }
+        return std::make_pair(s, t);
+     }
+
+    /**
+     * @brief Splits the intersection polylines of surface pairs with a common surface where they cross, 
+     *        so that the polylines only meet at their end points, as required for 1D features.
+     * @param curves the intersection polylines of each surface pair.
+     * @param pairs the surface pairs.
+     * @param tolerance the distance below which two polylines cross.
+     * @returns the split polylines.
+     */
+     static Polylines split_at_junctions(const std::vector<Polylines>& curves, const std::vector<std::pair<std::size_t,std::size_t>>& pairs, double tolerance)
+     {
+        typedef CGAL::Box_intersection_d::Box_with_info_d<double,3,std::pair<std::size_t,std::size_t>> Box;
+        struct Junction
+        {
+           std::size_t segment;
+           double parameter;
+           Point_3 point;
+        };
+        std::vector<const Polyline_3*> polylines;
+        std::vector<std::size_t> polyline_pair;
+        for(std::size_t k = 0; k < curves.size(); ++k)
+           for(auto const& polyline : curves[k])
+           {
+              polylines.push_back(&polyline);
+              polyline_pair.push_back(k);
+           }
+        std::vector<Box> boxes;
+        for(std::size_t p = 0; p < polylines.size(); ++p)
+           for(std::size_t i = 0; i+1 < polylines[p]->size(); ++i)
+           {
+              CGAL::Bbox_3 box = (*polylines[p])[i].bbox() + (*polylines[p])[i+1].bbox();
+              boxes.push_back(Box(CGAL::Bbox_3(box.xmin()-tolerance, box.ymin()-tolerance, box.zmin()-tolerance,
+                                               box.xmax()+tolerance, box.ymax()+tolerance, box.zmax()+tolerance), std::make_pair(p, i)));
+           }
+        std::vector<std::vector<Junction>> junctions(polylines.size());
+        CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), [&](const Box& a, const Box& b)
+        {
+           std::size_t p = a.info().first, q = b.info().first;
+           const auto& first = pairs[polyline_pair[p]];
+           const auto& second = pairs[polyline_pair[q]];
+           if( polyline_pair[p]==polyline_pair[q] or 
+               (first.first!=second.first and first.first!=second.second and first.second!=second.first and first.second!=second.second) )
+             return;
+           std::size_t i = a.info().second, j = b.info().second;
+           const Point_3& p1 = (*polylines[p])[i];
+           const Point_3& q1 = (*polylines[p])[i+1];
+           const Point_3& p2 = (*polylines[q])[j];
+           const Point_3& q2 = (*polylines[q])[j+1];
+           std::pair<double,double> st = closest_segment_parameters(p1, q1, p2, q2);
+           Point_3 x = p1 + st.first*(q1-p1);
+           Point_3 y = p2 + st.second*(q2-p2);
+           if( CGAL::squared_distance(x, y)>tolerance*tolerance )
+             return;
+           Point_3 junction = CGAL::midpoint(x, y);
+           junctions[p].push_back(Junction{i, st.first, junction});
+           junctions[q].push_back(Junction{j, st.second, junction});
+        });
+
+        Polylines result;
+        for(std::size_t p = 0; p < polylines.size(); ++p)
+        {
+           const Polyline_3& polyline = *polylines[p];
+           if( junctions[p].empty() )
+           {
+             result.push_back(polyline);
+             continue;
+           }
+           std::sort(junctions[p].begin(), junctions[p].end(), [](const Junction& a, const Junction& b)
+                     { return a.segment<b.segment or (a.segment==b.segment and a.parameter<b.parameter); });
+           // The polyline points with the junctions inserted, where a junction at a segment end replaces the end point.
+           std::vector<Point_3> points;
+           std::vector<bool> is_junction;
+           std::size_t next_junction = 0;
+           for(std::size_t i = 0; i < polyline.size(); ++i)
+           {
+              points.push_back(polyline[i]);
+              is_junction.push_back(false);
+              for(; next_junction < junctions[p].size() and junctions[p][next_junction].segment==i; ++next_junction)
+              {
+                 const Junction& junction = junctions[p][next_junction];
+                 if( is_junction.back() and CGAL::squared_distance(points.back(), junction.point)<=tolerance*tolerance )
+                   continue;
+                 if( junction.parameter<=0 )
+                 {
+                   points.back() = junction.point;
+                   is_junction.back() = true;
+                 }
+                 else if( junction.parameter<1 )
+                 {
+                   points.push_back(junction.point);
+                   is_junction.push_back(true);
+                 }
+                 else
+                 {
+                   points.push_back(junction.point);
+                   is_junction.push_back(true);
+                   ++i;
+                 }
+              }
+           }
+           if( polyline.size()>2 and polyline.front()==polyline.back() )
+           {
+             // Starts the closed polyline at a junction, so that it is split into open polylines.
+             if( is_junction.back() )
+             {
+               points.front() = points.back();
+               is_junction.front() = true;
+             }
+             points.pop_back();
+             is_junction.pop_back();
+             std::size_t first = std::find(is_junction.begin(), is_junction.end(), true) - is_junction.begin();
+             std::rotate(points.begin(), points.begin()+first, points.end());
+             std::rotate(is_junction.begin(), is_junction.begin()+first, is_junction.end());
+             points.push_back(points.front());
+             is_junction.push_back(true);
+           }
+           Polyline_3 part{points.front()};
+           for(std::size_t i = 1; i < points.size(); ++i)
+           {
+              part.push_back(points[i]);
+              if( is_junction[i] and i+1 < points.size() )
+              {
+                result.push_back(part);
+                part = Polyline_3{points[i]};
+              }
+           }
+           result.push_back(part);
+        }
+        return result;
+     }
+
+    /**
+     * @brief Checks the input surfaces with check_surfaces before refinement starts.
+     * @throws InvalidArgumentError with the clashing surfaces and locations if the surfaces clash.
+     */
+     void assert_no_surface_clashes()
+     {
+        std::vector<SurfaceClash> clashes = check_surfaces();
+        if( clashes.empty() )
+          return;
+        std::ostringstream message;
+        message << "The input surfaces clash:";
+        for(auto const& clash : clashes)
+           message << "\n  " << clash.type << " of surfaces " << clash.first << " and " << clash.second 
+                   << " (" << clash.count << ") at " << clash.location[0] << " " << clash.location[1] << " " << clash.location[2];
+        throw InvalidArgumentError(message.str().c_str());
+     }
+
+    /**
+     * @brief Deletes the polyhedral mesh domains, the labeled mesh domain and the bounding sphere points.
+     *        The reference surfaces of morph are kept.
+     */
+     void clear_meshing_inputs()
+     {
+        domain_ptr.reset();
+        features_registered = false;
+        for( auto vit : this->v)
+           delete vit;
+        Function_vector().swap(v);
+        min_sphere.clear();
+        polyhedral_domain_bytes = 0;
+     }
+
+    /**
+     * @brief Stores the points and faces of an input surface as a reference surface of morph.
+     * @param polyhedron the input surface.
+     */
+     void add_reference_surface(const Polyhedron& polyhedron)
+     {
+        reference_points.emplace_back();
+        reference_faces.emplace_back();
+        CGAL::Polygon_mesh_processing::polygon_mesh_to_polygon_soup(polyhedron, reference_points.back(), reference_faces.back());
+     }
+
+    /**
+     * @brief Returns the barycentric coordinates of a point in the plane of a triangle.
+     * @param triangle the triangle.
+     * @param point the point, e.g. the closest point on the triangle.
+     * @returns the coordinates of the three triangle vertices.
+     */
+     static std::array<double,3> barycentric_coordinates(const Triangle_3& triangle, const Point_3& point)
+     {
+        Kernel::Vector_3 e1 = triangle[1] - triangle[0];
+        Kernel::Vector_3 e2 = triangle[2] - triangle[0];
+        Kernel::Vector_3 d = point - triangle[0];
+        double d11 = e1*e1, d12 = e1*e2, d22 = e2*e2;
+        double denominator = d11*d22 - d12*d12;
+        if( denominator<=0 )
+          return std::array<double,3>{1., 0., 0.};
+        double d1 = d*e1, d2 = d*e2;
+        double b1 = (d22*d1 - d12*d2)/denominator;
+        double b2 = (d11*d2 - d12*d1)/denominator;
+        return std::array<double,3>{1. - b1 - b2, b1, b2};
+     }
+
+    /**
+     * @brief Rebuilds the triangulation from the finite vertices that are not removed. The vertex dimension 
+     *        and index, the corners and the 1D features with both vertices kept are copied, while the facets 
+     *        and cells are restored by the next refinement.
+     * @param removed the removed vertices.
+     */
+     void rebuild_triangulation(const std::set<Vertex_handle>& removed)
+     {
+        ScopedTimer timer("Domain::rebuild_triangulation");
+        const Tr& tr = c3t3.triangulation();
+        C3t3 rebuilt;
+        Tr& rebuilt_tr = rebuilt.triangulation();
+        std::map<Vertex_handle,Vertex_handle> vertex_map;
+        Cell_handle hint;
+        for(Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit)
+        {
+           if( removed.count(vit) )
+             continue;
+           Vertex_handle vh = rebuilt_tr.insert(tr.point(vit), hint);
+           if( vh==Vertex_handle() )
+             continue;
+           hint = vh->cell();
+           vh->set_dimension(vit->in_dimension());
+           vh->set_index(vit->index());
+           vertex_map[vit] = vh;
+        }
+        for(auto vit = c3t3.vertices_in_complex_begin(); vit != c3t3.vertices_in_complex_end(); ++vit)
+           if( vertex_map.count(vit) )
+             rebuilt.add_to_complex(vertex_map[vit], c3t3.corner_index(vit));
+        for(auto eit = c3t3.edges_in_complex_begin(); eit != c3t3.edges_in_complex_end(); ++eit)
+        {
+           auto a = vertex_map.find(eit->first->vertex(eit->second));
+           auto b = vertex_map.find(eit->first->vertex(eit->third));
+           Cell_handle c;
+           int i, j;
+           if( a!=vertex_map.end() and b!=vertex_map.end() and rebuilt_tr.is_edge(a->second, b->second, c, i, j) )
+             rebuilt.add_to_complex(a->second, b->second, c3t3.curve_index(*eit));
+        }
+        c3t3.swap(rebuilt);
+     }
+
+    /**
+     * @brief Returns a bounding box enlarged by a distance in each direction.
+     * @param bbox the bounding box.
+     * @param distance the distance.
+     * @returns the enlarged bounding box.
+     */
+     static CGAL::Bbox_3 dilate(const CGAL::Bbox_3& bbox, double distance)
+     {
+        return CGAL::Bbox_3(bbox.xmin()-distance, bbox.ymin()-distance, bbox.zmin()-distance,
+                            bbox.xmax()+distance, bbox.ymax()+distance, bbox.zmax()+distance);
+     }
+
+    /**
+     * @brief Returns the intersection of two bounding boxes.
+     * @param bbox the bounding box.
+     * @param region the bounding box of the region, e.g. the region of interest.
+     * @returns the intersection, which is empty if the boxes do not overlap, @see is_empty.
+     */
+     static CGAL::Bbox_3 clip(const CGAL::Bbox_3& bbox, const CGAL::Bbox_3& region)
+     {
+        return CGAL::Bbox_3(std::max(bbox.xmin(), region.xmin()), std::max(bbox.ymin(), region.ymin()), std::max(bbox.zmin(), region.zmin()),
+                            std::min(bbox.xmax(), region.xmax()), std::min(bbox.ymax(), region.ymax()), std::min(bbox.zmax(), region.zmax()));
+     }
+
+    /**
+     * @brief Returns true if a bounding box has no volume.
+     * @param bbox the bounding box.
+     * @returns true if the box is empty. 
+     */
+     static bool is_empty(const CGAL::Bbox_3& bbox)
+     {
+        return bbox.xmin()>=bbox.xmax() or bbox.ymin()>=bbox.ymax() or bbox.zmin()>=bbox.zmax();
+     }
+
+    /**
+     * @brief Groups the surfaces, borders and features, @see mesh_features(), into clusters, where the bounding boxes of 
+     *        different clusters are separated by more than twice a distance. Clusters without surfaces are ignored.
+     * @param distance the separation distance, e.g. the cell size.
+     * @returns the clusters.
+     */
+     std::vector<Cluster> make_clusters(double distance) const
+     {
+        typedef CGAL::Box_intersection_d::Box_with_info_d<double,3,std::size_t> Box;
+        std::vector<CGAL::Bbox_3> bboxes;
+        for(auto const& polyhedral_domain : v)
+           bboxes.push_back(polyhedral_domain->bbox());
+        Polylines protected_features = mesh_features();
+        for(const Polylines* polylines : {&borders, &protected_features})
+           for(auto const& polyline : *polylines)
+              bboxes.push_back(polyline.empty() ? CGAL::Bbox_3() : CGAL::bbox_3(polyline.begin(), polyline.end()));
+
+        std::vector<Box> boxes;
+        for(std::size_t i = 0; i < bboxes.size(); ++i)
+           boxes.push_back(Box(dilate(bboxes[i], distance), i));
+        std::vector<std::size_t> parent(bboxes.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&](std::size_t i)
+        {
+           while( parent[i]!=i )
+              i = parent[i] = parent[parent[i]];
+           return i;
+        };
+        CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), [&](const Box& a, const Box& b)
+        {
+           parent[find(a.info())] = find(b.info());
+        });
+
+        std::map<std::size_t,std::size_t> cluster_number;
+        std::vector<Cluster> clusters;
+        for(std::size_t i = 0; i < bboxes.size(); ++i)
+        {
+           std::size_t root = find(i);
+           if( !cluster_number.count(root) )
+           {
+             cluster_number[root] = clusters.size();
+             clusters.emplace_back();
+           }
+           Cluster& cluster = clusters[cluster_number[root]];
+           cluster.bbox += bboxes[i];
+           if( i < v.size() )
+             cluster.surfaces.push_back(i);
+           else if( i < v.size() + borders.size() )
+             cluster.borders.push_back(borders[i-v.size()]);
+           else 
+             cluster.features.push_back(protected_features[i-v.size()-borders.size()]);
+        }
+        clusters.erase(std::remove_if(clusters.begin(), clusters.end(), [](const Cluster& cluster) { return cluster.surfaces.empty(); }), 
+                       clusters.end());
+        return clusters;
+     }
+
+    /**
+     * @brief Merges complexes into the mesh stored in c3t3 by inserting their vertices into one triangulation,
+     *        and adding the cells, facets, edges and corners of the complexes with their tags. 
+     * @param parts the complexes, e.g. of separate clusters.
+     * @returns false if a vertex is hidden or a simplex of a complex is not in the merged triangulation, 
+     *          i.e. the complexes are too close to be merged. 
+     */
+     bool merge_complexes(const std::vector<C3t3>& parts)
+     {
+        ScopedTimer timer("Domain::merge_complexes");
+        c3t3.clear();
+        Tr& tr = c3t3.triangulation();
+        std::vector<std::map<Vertex_handle,Vertex_handle>> vertex_maps(parts.size());
+        std::size_t number_of_vertices = 0;
+        for(std::size_t n = 0; n < parts.size(); ++n)
+        {
+           const Tr& part_tr = parts[n].triangulation();
+           Cell_handle hint;
+           for(Finite_vertices_iterator vit = part_tr.finite_vertices_begin(); vit != part_tr.finite_vertices_end(); ++vit)
+           {
+              Vertex_handle vh = tr.insert(part_tr.point(vit), hint);
+              if( vh==Vertex_handle() )
+                return false;
+              hint = vh->cell();
+              vh->set_dimension(vit->in_dimension());
+              vh->set_index(vit->index());
+              vertex_maps[n][vit] = vh;
+           }
+           number_of_vertices += part_tr.number_of_vertices();
+        }
+        // A vertex hidden by a vertex of another complex is removed from the triangulation.
+        if( tr.number_of_vertices()!=number_of_vertices )
+          return false;
+
+        for(std::size_t n = 0; n < parts.size(); ++n)
+        {
+           const C3t3& part = parts[n];
+           std::map<Vertex_handle,Vertex_handle>& vertex_map = vertex_maps[n];
+           for(Cell_iterator cit = part.cells_in_complex_begin(); cit != part.cells_in_complex_end(); ++cit)
+           {
+              Cell_handle c;
+              if( !tr.is_cell(vertex_map[cit->vertex(0)], vertex_map[cit->vertex(1)], vertex_map[cit->vertex(2)], vertex_map[cit->vertex(3)], c) )
+                return false;
+              c3t3.add_to_complex(c, part.subdomain_index(cit));
+           }
+           for(Facet_iterator fit = part.facets_in_complex_begin(); fit != part.facets_in_complex_end(); ++fit)
+           {
+              Cell_handle c;
+              int i, j, k;
+              if( !tr.is_facet(vertex_map[fit->first->vertex((fit->second+1)%4)], vertex_map[fit->first->vertex((fit->second+2)%4)], 
+                               vertex_map[fit->first->vertex((fit->second+3)%4)], c, i, j, k) )
+                return false;
+              c3t3.add_to_complex(c, 6-i-j-k, part.surface_patch_index(*fit));
+           }
+           for(auto eit = part.edges_in_complex_begin(); eit != part.edges_in_complex_end(); ++eit)
+           {
+              Vertex_handle a = vertex_map[eit->first->vertex(eit->second)];
+              Vertex_handle b = vertex_map[eit->first->vertex(eit->third)];
+              Cell_handle c;
+              int i, j;
+              if( !tr.is_edge(a, b, c, i, j) )
+                return false;
+              c3t3.add_to_complex(a, b, part.curve_index(*eit));
+           }
+           for(auto vit = part.vertices_in_complex_begin(); vit != part.vertices_in_complex_end(); ++vit)
+              c3t3.add_to_complex(vertex_map[vit], part.corner_index(vit));
+        }
+        return true;
+     }
+
+    /**
+     * @brief Refines the current mesh against the meshing inputs with the criteria of a mesh resolution,
+     *        without exude and perturb, and post-processes the mesh.
+     * @param mesh_resolution the mesh resolution.
+     * @returns true if completed, false if stopped by the active CancellationToken.
+     */
+     bool refine_existing_mesh(double mesh_resolution)
+     {
+        double r = min_sphere.get_bounding_sphere_radius(); 
+        return refine_existing_mesh(resolution_criteria(r, mesh_resolution));
+     }
+
+    /**
+     * @brief Refines the current mesh against the meshing inputs with mesh criteria,
+     *        without exude and perturb, and post-processes the mesh.
+     * @param criteria the mesh criteria.
+     * @returns true if completed, false if stopped by the active CancellationToken.
+     * @overload
+     */
+     bool refine_existing_mesh(const Mesh_criteria& criteria)
+     {
+        {
+           ScopedTimer timer("Domain::refine_mesh_3");
+           DeadlineWatcher watcher;
+           CGAL::refine_mesh_3(c3t3, *domain_ptr.get(), criteria, CGAL::parameters::no_exude(), CGAL::parameters::no_perturb(),
+                               CGAL::parameters::mesh_3_options(
+                               CGAL::parameters::pointer_to_stop_atomic_boolean(watcher.stop_flag())));
+        }
+        return complete_meshing();
+     }
+
+    /**
+     * @brief Constructs a finalized Domain object without meshing inputs, used for the meshes of create_mesh_sweep.
+     * @param map the subdomain map of the source Domain object.
+     * @param borders the borders of the source Domain object.
+     * @param features the features of the source Domain object.
+     * @param resolution the mesh resolution of the source Domain object.
+     * @param number_of_surfaces the number of surfaces of the source Domain object.
+     */
+     Domain(std::shared_ptr<AbstractMap> map, Polylines borders, Polylines features, double resolution, std::size_t number_of_surfaces)
+     : map_ptr(map), borders(borders), features(features), resolution(resolution)
+     {
+        number_of_input_surfaces = number_of_surfaces;
+        finalized = true;
+     }
+
+    /**
+     * @brief Writes a part of the mesh in the medit format, and the vertex and cell numbers of the part 
+     *        in the mesh written with save, @see save_partitions.
+     * @param outpath the path to the output files without extension.
+     * @param cells the cells of the part followed by the ghost cells.
+     * @param is_selected the set of cells.
+     * @param cell_number the number of each cell in the mesh written with save.
+     * @param vertex_number the number of each vertex in the mesh written with save.
+     * @param cell_part the part of each cell.
+     * @param vertex_pmap the vertex tags.
+     * @param cell_pmap the cell tags.
+     * @param facet_map the facet tags of each pair of subdomain tags.
+     * @param save_1Dfeatures option to save the edges with tags.
+     */
+     template<typename Vertex_pmap, typename Cell_pmap>
+     void write_partition(std::string outpath, const std::vector<Cell_handle>& cells, const std::set<Cell_handle>& is_selected,
+                          std::map<Cell_handle,std::size_t>& cell_number, std::map<Vertex_handle,int>& vertex_number,
+                          std::map<Cell_handle,int>& cell_part, const Vertex_pmap& vertex_pmap, const Cell_pmap& cell_pmap, std::map<std::pair<int,int>,int>& facet_map,
+                          bool save_1Dfeatures)
+     {
+        const Tr& tr = c3t3.triangulation();
+        std::vector<Vertex_handle> vertices;
+        std::set<Vertex_handle> is_used;
+        for(Cell_handle c : cells)
+           for(int i = 0; i < 4; ++i)
+              if( is_used.insert(c->vertex(i)).second )
+                vertices.push_back(c->vertex(i));
+        if( output_ordering!="none" )
+          std::sort(vertices.begin(), vertices.end(), [&](Vertex_handle a, Vertex_handle b) { return vertex_number[a]<vertex_number[b]; });
+        std::map<Vertex_handle,int> V;
+        for(Vertex_handle vh : vertices)
+        {
+           int number = V.size() + 1;
+           V[vh] = number;
+        }
+
+        std::ofstream os(outpath + ".mesh");
+        os << std::setprecision(17);
+        os << "MeshVersionFormatted 1\n"
+           << "Dimension 3\n";
+        os << "Vertices\n" << vertices.size() << '\n';
+        for(Vertex_handle vh : vertices)
         {
+           Weighted_point p = tr.point(vh);
+           os << CGAL::to_double(p.x()) << ' '
+              << CGAL::to_double(p.y()) << ' '
+              << CGAL::to_double(p.z()) << ' '
+              << get(vertex_pmap, vh) << '\n';
+        }
 
-           Facet f = (*fit);
+        if( save_1Dfeatures )
+        {
+          std::map<std::pair<int,int>,int> edges;
+          for(Cell_handle c : cells)
+             for(int i = 0; i < 4; ++i)
+                for(int j = i+1; j < 4; ++j)
+                {
+                   std::pair<int,int> key(V[c->vertex(i)], V[c->vertex(j)]);
+                   if( edges.find(key)==edges.end() and edges.find(std::make_pair(key.second,key.first))==edges.end() )
+                     edges[key] = static_cast<int>(c3t3.curve_index(Edge(c,i,j)));
+                }
+          os << "Edges\n" << edges.size() << '\n';
+          for(auto const& edge : edges)
+             os << edge.first.first << " " << edge.first.second << " " << edge.second << '\n';
+        }
+
+        std::vector<Facet> facets;
+        for(Cell_handle c : cells)
+           for(int i = 0; i < 4; ++i)
+           {
+              Cell_handle n = c->neighbor(i);
+              if( is_selected.find(n)==is_selected.end() or c<n )
+                facets.push_back(Facet(c,i));
+           }
+        os << "Triangles\n" << facets.size() << '\n';
+        for(Facet f : facets)
+        {
+           Surface_patch_index spi = c3t3.surface_patch_index(f);
            if( f.first->subdomain_index()>f.first->neighbor(f.second)->subdomain_index() )
-               f = tr.mirror_facet(f);
+             f = tr.mirror_facet(f);
+           Vertex_handle vh1 = f.first->vertex((f.second + 1) % 4);
+           Vertex_handle vh2 = f.first->vertex((f.second + 2) % 4);
+           Vertex_handle vh3 = f.first->vertex((f.second + 3) % 4);
+           if( f.second%2!=0 )
+             std::swap(vh2, vh3);
+           std::pair<int,int> key(static_cast<int>(spi.first), static_cast<int>(spi.second));
+           if( key.second>key.first )
+             std::swap(key.first,key.second);
+           os << V[vh1] << ' ' << V[vh2] << ' ' << V[vh3] << ' ';
+           os << ( facet_map.find(key)==facet_map.end() ? 0 : facet_map.at(key) ) << '\n';
+        }
 
-           if( c3t3.is_in_complex(fit->first) or c3t3.is_in_complex(fit->first->neighbor(fit->second)) )  
-           {    
-              if( facet_data.find(f)==facet_data.end() )
-                  os << 0.0 << '\n'; 
-               else
-                  os << facet_data.at(f) << '\n'; 
+        os << "Tetrahedra\n" << cells.size() << '\n';
+        for(Cell_handle c : cells)
+        {
+           for(int i = 0; i < 4; ++i)
+              os << V[c->vertex(i)] << ' ';
+           os << get(cell_pmap, c) << '\n';
+        }
+        os << "End\n";
+        os.close();
+
+        std::ofstream map_file(outpath + ".map");
+        map_file << "Vertices\n" << vertices.size() << '\n';
+        for(Vertex_handle vh : vertices)
+           map_file << vertex_number[vh] << '\n';
+        map_file << "Tetrahedra\n" << cells.size() << '\n';
+        for(Cell_handle c : cells)
+           map_file << cell_number[c] + 1 << ' ' << cell_part[c] << '\n';
+        map_file.close();
+     }
+
+    /**
+     * @brief Returns the vertices and the cells of the mesh in the output ordering, @see set_output_ordering.
+     *
+     * The ordering is computed once per mesh, and recomputed after clear_output_order().
+     * @param[out] vertices the finite vertices of the triangulation.
+     * @param[out] cells the cells in the complex.
+     */
+     void output_order(std::vector<Vertex_handle>& vertices, std::vector<Cell_handle>& cells) const
+     {
+        if( !has_output_order )
+        {
+          compute_output_order(output_vertices, output_cells);
+          has_output_order = true;
+        }
+        vertices = output_vertices;
+        cells = output_cells;
+     }
+
+    /**
+     * @brief Removes the cached output ordering, when the mesh or the ordering is changed.
+     */
+     void clear_output_order()
+     {
+        has_output_order = false;
+        std::vector<Vertex_handle>().swap(output_vertices);
+        std::vector<Cell_handle>().swap(output_cells);
+     }
+
+    /**
+     * @brief Computes the vertices and the cells of the mesh in the output ordering.
+     * @param[out] vertices the finite vertices of the triangulation.
+     * @param[out] cells the cells in the complex.
+     */
+     void compute_output_order(std::vector<Vertex_handle>& vertices, std::vector<Cell_handle>& cells) const
+     {
+        ScopedTimer timer("Domain::output_order");
+        const Tr& tr = c3t3.triangulation();
+        vertices.clear();
+        cells.clear();
+        for(Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit)
+           vertices.push_back(vit);
+        for(Cell_iterator cit = c3t3.cells_in_complex_begin(); cit != c3t3.cells_in_complex_end(); ++cit)
+           cells.push_back(cit);
+        if( output_ordering=="none" )
+          return;
+
+        typedef CGAL::Spatial_sort_traits_adapter_3<Kernel, CGAL::Pointer_property_map<Point_3>::const_type> Sort_traits;
+        auto hilbert_order = [](const std::vector<Point_3>& points)
+        {
+           std::vector<std::ptrdiff_t> indices(points.size());
+           std::iota(indices.begin(), indices.end(), 0);
+           CGAL::hilbert_sort(indices.begin(), indices.end(), Sort_traits(CGAL::make_property_map(points)));
+           return indices;
+        };
+        if( output_ordering=="hilbert" )
+        {
+          std::vector<Point_3> points;
+          for(Vertex_handle vh : vertices)
+             points.push_back(tr.point(vh).point());
+          std::vector<Vertex_handle> ordered;
+          for(std::ptrdiff_t i : hilbert_order(points))
+             ordered.push_back(vertices[i]);
+          vertices.swap(ordered);
+
+          std::vector<Point_3> centroids;
+          for(Cell_handle c : cells)
+          {
+             double x = 0, y = 0, z = 0;
+             for(int i = 0; i < 4; ++i)
+             {
+                Point_3 p = tr.point(c->vertex(i)).point();
+                x += p.x()/4.;
+                y += p.y()/4.;
+                z += p.z()/4.;
+             }
+             centroids.push_back(Point_3(x, y, z));
+          }
+          std::vector<Cell_handle> ordered_cells;
+          for(std::ptrdiff_t i : hilbert_order(centroids))
+             ordered_cells.push_back(cells[i]);
+          cells.swap(ordered_cells);
+          return;
+        }
+
+        std::map<Vertex_handle,std::size_t> vertex_index;
+        for(Vertex_handle vh : vertices)
+        {
+           std::size_t index = vertex_index.size();
+           vertex_index[vh] = index;
+        }
+        std::vector<std::set<std::size_t>> neighbours(vertices.size());
+        for(Cell_handle c : cells)
+           for(int i = 0; i < 4; ++i)
+              for(int j = 0; j < 4; ++j)
+                 if( i!=j )
+                   neighbours[vertex_index[c->vertex(i)]].insert(vertex_index[c->vertex(j)]);
+        CSR_graph graph;
+        for(auto const& adjacent : neighbours)
+        {
+           graph.vertex_weights.push_back(1);
+           for(std::size_t j : adjacent)
+           {
+              graph.adjacency.push_back(j);
+              graph.edge_weights.push_back(1);
            }
+           graph.offsets.push_back(graph.adjacency.size());
+        }
+        std::vector<Vertex_handle> ordered;
+        std::vector<std::size_t> rank(vertices.size());
+        std::vector<std::size_t> order = reverse_cuthill_mckee(graph);
+        for(std::size_t i = 0; i < order.size(); ++i)
+        {
+           rank[order[i]] = i;
+           ordered.push_back(vertices[order[i]]);
+        }
+        vertices.swap(ordered);
+
+        // The cells are ordered by the sorted ranks of their vertices.
+        std::vector<std::pair<std::array<std::size_t,4>,Cell_handle>> keys;
+        for(Cell_handle c : cells)
+        {
+           std::array<std::size_t,4> key;
+           for(int i = 0; i < 4; ++i)
+              key[i] = rank[vertex_index[c->vertex(i)]];
+           std::sort(key.begin(), key.end());
+           keys.push_back(std::make_pair(key, c));
         }
+        std::stable_sort(keys.begin(), keys.end(), [](const std::pair<std::array<std::size_t,4>,Cell_handle>& a,
+                                                      const std::pair<std::array<std::size_t,4>,Cell_handle>& b) { return a.first<b.first; });
+        for(std::size_t i = 0; i < keys.size(); ++i)
+           cells[i] = keys[i].second;
      }
-   
 
+    /**
+     * @brief Returns the facet seen from a cell in the complex, so that a facet has the same 
+     *        representation after the cells outside the complex are changed, e.g. by remove_subdomain.
+     * @param f a facet of the triangulation.
+     * @returns the facet seen from the cell in the complex, or the smallest cell handle if both or neither are.
+     */
+     Facet canonical_facet(Facet f) const
+     {
+        Facet mirror = c3t3.triangulation().mirror_facet(f);
+        bool first = c3t3.is_in_complex(f.first);
+        bool second = c3t3.is_in_complex(mirror.first);
+        if( (second and !first) or (first==second and mirror.first<f.first) )
+          return mirror;
+        return f;
+     }
+
+    /**
+     * @brief Returns the facets written with save, i.e. the finite facets with a cell in the complex, 
+     *        in the order of the Triangles section.
+     * @param[out] facets the facets, @see canonical_facet.
+     */
+     void output_facets(std::vector<Facet>& facets) const
+     {
+        const Tr& tr = c3t3.triangulation();
+        facets.clear();
+        for(auto fit = tr.finite_facets_begin(); fit != tr.finite_facets_end(); ++fit)
+           if( c3t3.is_in_complex(fit->first) or c3t3.is_in_complex(fit->first->neighbor(fit->second)) )
+             facets.push_back(canonical_facet(*fit));
+     }
+
+    /**
+     * @brief Renumbers the values of a data field from one list of entities to another.
+     * @param old_entities the entities of the values.
+     * @param new_entities the entities of the returned values.
+     * @param values the values with the components of each entity stored consecutively.
+     * @param components the number of components per entity.
+     * @returns the values of the new entities, or zero for entities that are not in the old list.
+     */
+     template<typename Entity>
+     static std::vector<double> remap_values(const std::vector<Entity>& old_entities, const std::vector<Entity>& new_entities,
+                                             const std::vector<double>& values, int components)
+     {
+        std::map<Entity,std::size_t> index;
+        for(std::size_t i = 0; i < old_entities.size(); ++i)
+           index[old_entities[i]] = i;
+        std::vector<double> result(new_entities.size()*components, 0.0);
+        for(std::size_t i = 0; i < new_entities.size(); ++i)
+        {
+           auto it = index.find(new_entities[i]);
+           if( it!=index.end() )
+             std::copy(values.begin() + it->second*components, values.begin() + (it->second+1)*components,
+                       result.begin() + i*components);
+        }
+        return result;
+     }
+
+    /**
+     * @brief Renumbers the data fields to the current entities of the mesh and the output ordering.
+     */
+     void update_data()
+     {
+        if( data_fields.empty() )
+          return;
+        std::vector<Vertex_handle> vertices;
+        std::vector<Cell_handle> cells;
+        std::vector<Facet> facets;
+        output_order(vertices, cells);
+        output_facets(facets);
+        if( vertices==data_vertices and cells==data_cells and facets==data_facets )
+          return;
+        for(auto& field : data_fields)
+        {
+           Data_field& data = field.second;
+           if( data.entity=="vertex" )
+             data.values = remap_values(data_vertices, vertices, data.values, data.components);
+           else if( data.entity=="cell" )
+             data.values = remap_values(data_cells, cells, data.values, data.components);
+           else
+             data.values = remap_values(data_facets, facets, data.values, data.components);
+        }
+        data_vertices.swap(vertices);
+        data_cells.swap(cells);
+        data_facets.swap(facets);
+     }
+
+    /**
+     * @brief Sets the subdomain tags of cells in the complex, and updates the facets of the changed cells.
+     *
+     * A facet between cells with the same tag is removed from the complex, and otherwise 
+     * added with the surface patch index of the tags, with the largest tag first.
+     * @param labels pairs of cells in the complex and non-zero tags.
+     * @returns the number of cells with changed tags.
+     */
+     int relabel_cells(const std::vector<std::pair<Cell_handle,int>>& labels)
+     {
+        std::vector<Cell_handle> changed;
+        for(auto const& label : labels)
+        {
+           if( static_cast<int>(c3t3.subdomain_index(label.first))==label.second )
+             continue;
+           c3t3.remove_from_complex(label.first);
+           c3t3.add_to_complex(label.first, Subdomain_index(label.second));
+           changed.push_back(label.first);
+        }
+        for(Cell_handle c : changed)
+           for(int i = 0; i < 4; ++i)
+           {
+              Cell_handle n = c->neighbor(i);
+              int first = static_cast<int>(c3t3.subdomain_index(c));
+              int second = c3t3.is_in_complex(n) ? static_cast<int>(c3t3.subdomain_index(n)) : 0;
+              if( c3t3.is_in_complex(c,i) )
+                c3t3.remove_from_complex(c,i);
+              if( first==second )
+                continue;
+              if( first<second )
+                std::swap(first, second);
+              c3t3.add_to_complex(c, i, Surface_patch_index(Subdomain_index(first), Subdomain_index(second)));
+           }
+        c3t3.rescan_after_load_of_triangulation();
+        clear_output_order();
+        update_data();
+        return static_cast<int>(changed.size());
+     }
+
+    /**
+     * @brief Removes the data fields and the entities they refer to.
+     */
+     void clear_data()
+     {
+        data_fields.clear();
+        data_vertices.clear();
+        data_cells.clear();
+        data_facets.clear();
+     }
+
+    /**
+     * @brief Removes the data that refers to the cells of the mesh, i.e. the partition and the data fields,
+     *        before the mesh is changed.
+     */
+     void clear_mesh_data()
+     {
+        cell_partition.clear();
+        partition_cells.clear();
+        number_of_parts = 0;
+        clear_output_order();
+        clear_data();
+     }
+
+     void assert_data_entity(const std::string& entity) const
+     {
+        if( entity!="vertex" and entity!="facet" and entity!="cell" )
+          throw InvalidArgumentError(("Unknown data entity: " + entity).c_str());
+     }
+
+     const Data_field& get_data_field(const std::string& name) const
+     {
+        auto it = data_fields.find(name);
+        if( it==data_fields.end() )
+          throw InvalidArgumentError(("No data field named: " + name).c_str());
+        return it->second;
+     }
+
+    /**
+     * @brief Appends an array to a binary file.
+     * @param os the binary output stream.
+     * @param values the array.
+     * @returns the offset of the array in the file.
+     */
+     template<typename T>
+     static std::size_t write_binary(std::ofstream& os, const std::vector<T>& values)
+     {
+        std::size_t offset = os.tellp();
+        os.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+        return offset;
+     }
+
+    /**
+     * @brief Refines a mesh by red refinement of the selected cells, and green refinement of their neighbours, 
+     *        @see refine.
+     *
+     * The edges to split are found first, and cells with other split edges than a single edge or 
+     * the three edges of a facet are red refined until the set of split edges is closed. The refined 
+     * cells are then constructed concurrently, and connected sequentially by matching their facets. 
+     * @param coarse the mesh to refine.
+     * @param[out] fine the refined mesh.
+     * @param subdomains the subdomain tags of the red refined cells, empty refines all cells. 
+     * @param num_threads the number of threads, non-positive uses the number of hardware threads.
+     */
+     static void red_refinement(const C3t3& coarse, C3t3& fine, const std::set<int>& subdomains, int num_threads)
+     {
+        ScopedTimer timer("Domain::red_refinement");
+        typedef std::pair<std::size_t,std::size_t> Edge_key;
+        typedef std::array<std::size_t,4> Tetrahedron;
+        typedef Mesh_domain::Index Index;
+        auto edge_key = [](std::size_t a, std::size_t b) { return a<b ? Edge_key(a,b) : Edge_key(b,a); };
+        const Tr& tr = coarse.triangulation();
+
+        std::vector<Point_3> points;
+        std::map<Vertex_handle,std::size_t> vertex_id;
+        std::vector<Vertex_handle> vertices;
+        for(Finite_vertices_iterator vit = tr.finite_vertices_begin(); vit != tr.finite_vertices_end(); ++vit)
+        {
+           vertex_id[vit] = points.size();
+           vertices.push_back(vit);
+           points.push_back(tr.point(vit).point());
+        }
+        std::vector<Tetrahedron> cells;
+        std::vector<int> cell_subdomain;
+        std::vector<char> red;
+        for(auto cit = tr.finite_cells_begin(); cit != tr.finite_cells_end(); ++cit)
+        {
+           Tetrahedron cell;
+           for(int i = 0; i < 4; ++i)
+              cell[i] = vertex_id[cit->vertex(i)];
+           int tag = coarse.is_in_complex(cit) ? static_cast<int>(coarse.subdomain_index(cit)) : 0;
+           cells.push_back(cell);
+           cell_subdomain.push_back(tag);
+           red.push_back(subdomains.empty() or ( tag!=0 and subdomains.count(tag)>0 ));
+        }
+
+        // Closure of the split edges
+        std::set<Edge_key> split;
+        auto add_edges = [&](const Tetrahedron& cell)
+        {
+           for(int i = 0; i < 4; ++i)
+              for(int j = i+1; j < 4; ++j)
+                 split.insert(edge_key(cell[i], cell[j]));
+        };
+        for(std::size_t c = 0; c < cells.size(); ++c)
+           if( red[c] )
+             add_edges(cells[c]);
+        bool changed = !subdomains.empty();
+        while( changed )
+        {
+           changed = false;
+           for(std::size_t c = 0; c < cells.size(); ++c)
+           {
+              if( red[c] )
+                continue;
+              int count = 0;
+              std::array<int,4> excluded{0, 0, 0, 0};
+              for(int i = 0; i < 4; ++i)
+                 for(int j = i+1; j < 4; ++j)
+                    if( split.count(edge_key(cells[c][i], cells[c][j])) )
+                    {
+                       ++count;
+                       for(int k = 0; k < 4; ++k)
+                          excluded[k] += (k!=i and k!=j);
+                    }
+              bool facet = count==3 and std::find(excluded.begin(), excluded.end(), 0)==excluded.end() and 
+                           std::find(excluded.begin(), excluded.end(), 3)!=excluded.end();
+              if( count>1 and !facet )
+              {
+                red[c] = true;
+                add_edges(cells[c]);
+                changed = true;
+              }
+           }
+        }
+        std::vector<Edge_key> split_edges(split.begin(), split.end());
+        std::set<Edge_key>().swap(split);
+        const std::size_t number_of_coarse_vertices = points.size();
+        for(auto const& edge : split_edges)
+           points.push_back(CGAL::midpoint(points[edge.first], points[edge.second]));
+        auto midpoint = [&](std::size_t a, std::size_t b) -> std::ptrdiff_t
+        {
+           auto it = std::lower_bound(split_edges.begin(), split_edges.end(), edge_key(a,b));
+           if( it==split_edges.end() or *it!=edge_key(a,b) )
+             return -1;
+           return number_of_coarse_vertices + (it - split_edges.begin());
+        };
+
+        // Refined cells, with the offset of the children of each coarse cell
+        std::vector<std::size_t> offsets(cells.size()+1, 0);
+        for(std::size_t c = 0; c < cells.size(); ++c)
+        {
+           int count = 0;
+           for(int i = 0; i < 4; ++i)
+              for(int j = i+1; j < 4; ++j)
+                 count += midpoint(cells[c][i], cells[c][j])>=0;
+           offsets[c+1] = offsets[c] + ( red[c] ? 8 : ( count==3 ? 4 : ( count==1 ? 2 : 1 ) ) );
+        }
+        std::vector<Tetrahedron> children(offsets.back());
+        std::vector<int> child_subdomain(offsets.back());
+        const std::size_t chunk = 1024;
+        parallel_for((cells.size() + chunk - 1)/chunk, num_threads, [&](std::size_t k)
+        {
+           for(std::size_t c = k*chunk; c < std::min((k+1)*chunk, cells.size()); ++c)
+           {
+              const Tetrahedron& v = cells[c];
+              std::vector<Tetrahedron> result;
+              std::size_t m[4][4];
+              std::vector<std::pair<int,int>> split_pairs;
+              for(int i = 0; i < 4; ++i)
+                 for(int j = i+1; j < 4; ++j)
+                 {
+                    std::ptrdiff_t k = midpoint(v[i], v[j]);
+                    m[i][j] = m[j][i] = static_cast<std::size_t>(k);
+                    if( k>=0 )
+                      split_pairs.push_back(std::make_pair(i,j));
+                 }
+              if( red[c] )
+              {
+                for(int i = 0; i < 4; ++i)
+                {
+                   Tetrahedron corner = v;
+                   for(int j = 0; j < 4; ++j)
+                      if( j!=i )
+                        corner[j] = m[i][j];
+                   result.push_back(corner);
+                }
+                // The octahedron is split along its shortest diagonal. 
+                const std::array<std::array<int,2>,3> diagonal{{{0,1}, {0,2}, {0,3}}};
+                int best = 0;
+                double length = std::numeric_limits<double>::max();
+                for(int d = 0; d < 3; ++d)
+                {
+                   int i = diagonal[d][0], j = diagonal[d][1];
+                   int k = (d==0 ? 2 : 1), l = 6 - i - j - k;
+                   double squared = CGAL::to_double(CGAL::squared_distance(points[m[i][j]], points[m[k][l]]));
+                   if( squared<length )
+                   {
+                     length = squared;
+                     best = d;
+                   }
+                }
+                int i = diagonal[best][0], j = diagonal[best][1];
+                int k = (best==0 ? 2 : 1), l = 6 - i - j - k;
+                // The ring of midpoints around the diagonal (ij,kl), where consecutive midpoints share a vertex. 
+                std::array<std::size_t,4> ring{m[i][k], m[k][j], m[j][l], m[l][i]};
+                for(int r = 0; r < 4; ++r)
+                   result.push_back(Tetrahedron{m[i][j], m[k][l], ring[r], ring[(r+1)%4]});
+              }
+              else if( split_pairs.size()==1 )
+              {
+                int i = split_pairs[0].first, j = split_pairs[0].second;
+                Tetrahedron first = v, second = v;
+                first[i] = m[i][j];
+                second[j] = m[i][j];
+                result.push_back(first);
+                result.push_back(second);
+              }
+              else if( split_pairs.size()==3 )
+              {
+                int apex = 0;
+                while( m[(apex+1)%4][(apex+2)%4]==static_cast<std::size_t>(-1) or m[(apex+1)%4][(apex+3)%4]==static_cast<std::size_t>(-1) )
+                   ++apex;
+                int a = (apex+1)%4, b = (apex+2)%4, d = (apex+3)%4;
+                result.push_back(Tetrahedron{m[a][b], m[b][d], m[d][a], v[apex]});
+                result.push_back(Tetrahedron{v[a], m[a][b], m[d][a], v[apex]});
+                result.push_back(Tetrahedron{v[b], m[b][d], m[a][b], v[apex]});
+                result.push_back(Tetrahedron{v[d], m[d][a], m[b][d], v[apex]});
+              }
+              else
+                result.push_back(v);
+
+              for(std::size_t r = 0; r < result.size(); ++r)
+              {
+                 Tetrahedron& t = result[r];
+                 if( CGAL::orientation(points[t[0]], points[t[1]], points[t[2]], points[t[3]])!=CGAL::POSITIVE )
+                   std::swap(t[0], t[1]);
+                 children[offsets[c] + r] = t;
+                 child_subdomain[offsets[c] + r] = cell_subdomain[c];
+              }
+           }
+        });
+
+        // Triangulation data structure of the refined mesh
+        Tr& fine_tr = fine.triangulation();
+        fine_tr.clear();
+        fine_tr.tds().delete_cell(fine_tr.infinite_vertex()->cell());
+        fine_tr.tds().set_dimension(3);
+        const std::size_t infinite = points.size();
+        std::vector<Vertex_handle> fine_vertices(points.size()+1);
+        for(std::size_t i = 0; i < points.size(); ++i)
+        {
+           fine_vertices[i] = fine_tr.tds().create_vertex();
+           fine_vertices[i]->set_point(Weighted_point(points[i]));
+        }
+        fine_vertices[infinite] = fine_tr.infinite_vertex();
+
+        std::vector<Cell_handle> fine_cells;
+        std::vector<Tetrahedron> fine_tetrahedra(children);
+        for(auto const& t : children)
+           fine_cells.push_back(fine_tr.tds().create_cell(fine_vertices[t[0]], fine_vertices[t[1]], fine_vertices[t[2]], fine_vertices[t[3]]));
+        typedef std::pair<std::array<std::size_t,3>,std::pair<std::size_t,int>> Facet_key;
+        auto facet_keys = [&](std::size_t first)
+        {
+           std::vector<Facet_key> keys;
+           for(std::size_t c = first; c < fine_tetrahedra.size(); ++c)
+              for(int i = 0; i < 4; ++i)
+              {
+                 std::array<std::size_t,3> key;
+                 for(int j = 0, k = 0; j < 4; ++j)
+                    if( j!=i )
+                      key[k++] = fine_tetrahedra[c][j];
+                 std::sort(key.begin(), key.end());
+                 keys.push_back(std::make_pair(key, std::make_pair(c, i)));
+              }
+           std::sort(keys.begin(), keys.end());
+           return keys;
+        };
+        // Facets that are not shared by two cells are on the convex hull, and get an infinite cell.
+        std::vector<Facet_key> keys = facet_keys(0);
+        for(std::size_t f = 0; f < keys.size(); ++f)
+        {
+           if( f+1 < keys.size() and keys[f].first==keys[f+1].first )
+           {
+             Cell_handle c = fine_cells[keys[f].second.first], n = fine_cells[keys[f+1].second.first];
+             c->set_neighbor(keys[f].second.second, n);
+             n->set_neighbor(keys[f+1].second.second, c);
+             ++f;
+             continue;
+           }
+           std::size_t c = keys[f].second.first;
+           int i = keys[f].second.second;
+           Tetrahedron t = fine_tetrahedra[c];
+           t[i] = infinite;
+           std::swap(t[(i+1)%4], t[(i+2)%4]);
+           Cell_handle n = fine_tr.tds().create_cell(fine_vertices[t[0]], fine_vertices[t[1]], fine_vertices[t[2]], fine_vertices[t[3]]);
+           fine_cells[c]->set_neighbor(i, n);
+           n->set_neighbor(i, fine_cells[c]);
+           fine_cells.push_back(n);
+           fine_tetrahedra.push_back(t);
+        }
+        std::vector<Facet_key> infinite_keys = facet_keys(children.size());
+        for(std::size_t f = 0; f+1 < infinite_keys.size(); ++f)
+           if( infinite_keys[f].first==infinite_keys[f+1].first and infinite_keys[f].first[2]==infinite )
+           {
+             Cell_handle c = fine_cells[infinite_keys[f].second.first], n = fine_cells[infinite_keys[f+1].second.first];
+             c->set_neighbor(infinite_keys[f].second.second, n);
+             n->set_neighbor(infinite_keys[f+1].second.second, c);
+             ++f;
+           }
+        for(Cell_handle c : fine_cells)
+           for(int i = 0; i < 4; ++i)
+              c->vertex(i)->set_cell(c);
+
+        // Complex of the refined mesh
+        std::vector<int> dimension(points.size(), -1);
+        for(std::size_t i = 0; i < number_of_coarse_vertices; ++i)
+        {
+           dimension[i] = vertices[i]->in_dimension();
+           fine_vertices[i]->set_dimension(vertices[i]->in_dimension());
+           fine_vertices[i]->set_index(vertices[i]->index());
+        }
+        for(std::size_t c = 0; c < children.size(); ++c)
+           if( child_subdomain[c]!=0 )
+           {
+             fine.add_to_complex(fine_cells[c], Subdomain_index(child_subdomain[c]));
+             for(int i = 0; i < 4; ++i)
+                if( dimension[children[c][i]]<0 )
+                {
+                  dimension[children[c][i]] = 3;
+                  fine_vertices[children[c][i]]->set_dimension(3);
+                  fine_vertices[children[c][i]]->set_index(Index(Subdomain_index(child_subdomain[c])));
+                }
+           }
+        for(std::size_t i = number_of_coarse_vertices; i < points.size(); ++i)
+           if( dimension[i]<0 )
+             fine_vertices[i]->set_dimension(3);
+
+        auto find_facet = [&](std::size_t a, std::size_t b, std::size_t c)
+        {
+           std::array<std::size_t,3> key{a, b, c};
+           std::sort(key.begin(), key.end());
+           auto it = std::lower_bound(keys.begin(), keys.end(), Facet_key(key, std::make_pair(0, 0)));
+           return Facet(fine_cells[it->second.first], it->second.second);
+        };
+        for(auto fit = coarse.facets_in_complex_begin(); fit != coarse.facets_in_complex_end(); ++fit)
+        {
+           Surface_patch_index patch = coarse.surface_patch_index(*fit);
+           std::array<std::size_t,3> t;
+           for(int j = 0, k = 0; j < 4; ++j)
+              if( j!=fit->second )
+                t[k++] = vertex_id[fit->first->vertex(j)];
+           std::vector<std::array<std::size_t,3>> triangles;
+           std::array<std::ptrdiff_t,3> m{midpoint(t[0],t[1]), midpoint(t[1],t[2]), midpoint(t[2],t[0])};
+           int count = (m[0]>=0) + (m[1]>=0) + (m[2]>=0);
+           if( count==3 )
+           {
+             triangles.push_back({std::size_t(m[0]), std::size_t(m[1]), std::size_t(m[2])});
+             triangles.push_back({t[0], std::size_t(m[0]), std::size_t(m[2])});
+             triangles.push_back({t[1], std::size_t(m[1]), std::size_t(m[0])});
+             triangles.push_back({t[2], std::size_t(m[2]), std::size_t(m[1])});
+           }
+           else if( count==1 )
+           {
+             int e = m[0]>=0 ? 0 : ( m[1]>=0 ? 1 : 2 );
+             triangles.push_back({t[e], std::size_t(m[e]), t[(e+2)%3]});
+             triangles.push_back({std::size_t(m[e]), t[(e+1)%3], t[(e+2)%3]});
+           }
+           else
+             triangles.push_back(t);
+           for(auto const& triangle : triangles)
+              fine.add_to_complex(find_facet(triangle[0], triangle[1], triangle[2]), patch);
+           for(int e = 0; e < 3; ++e)
+              if( m[e]>=0 and dimension[m[e]]!=1 )
+              {
+                dimension[m[e]] = 2;
+                fine_vertices[m[e]]->set_dimension(2);
+                fine_vertices[m[e]]->set_index(Index(patch));
+              }
+        }
+        for(auto eit = coarse.edges_in_complex_begin(); eit != coarse.edges_in_complex_end(); ++eit)
+        {
+           Curve_index curve = coarse.curve_index(*eit);
+           std::size_t a = vertex_id[eit->first->vertex(eit->second)];
+           std::size_t b = vertex_id[eit->first->vertex(eit->third)];
+           std::ptrdiff_t m = midpoint(a, b);
+           if( m<0 )
+           {
+             fine.add_to_complex(fine_vertices[a], fine_vertices[b], curve);
+             continue;
+           }
+           fine.add_to_complex(fine_vertices[a], fine_vertices[m], curve);
+           fine.add_to_complex(fine_vertices[m], fine_vertices[b], curve);
+           dimension[m] = 1;
+           fine_vertices[m]->set_dimension(1);
+           fine_vertices[m]->set_index(Index(curve));
+        }
+        for(auto vit = coarse.vertices_in_complex_begin(); vit != coarse.vertices_in_complex_end(); ++vit)
+           fine.add_to_complex(fine_vertices[vertex_id[vit]], coarse.corner_index(vit));
+        fine.rescan_after_load_of_triangulation();
+     }
+
+    /**
+     * @brief Returns the mesh criteria for a mesh resolution, @see create_mesh(const double)
+     * @param bounding_sphere_radius the radius of the minimum bounding sphere of the surfaces.
+     * @param mesh_resolution the mesh resolution.
+     * @returns the mesh criteria.
+     */
+     static Mesh_criteria resolution_criteria(double bounding_sphere_radius, double mesh_resolution)
+     {
+        const double cell_size = bounding_sphere_radius/mesh_resolution;
+        return Mesh_criteria(CGAL::parameters::edge_size = cell_size,
+                             CGAL::parameters::facet_angle = 30.0,
+                             CGAL::parameters::facet_size = cell_size,
+                             CGAL::parameters::facet_distance = cell_size/10.0, 
+                             CGAL::parameters::cell_radius_edge_ratio = 3.0,
+                             CGAL::parameters::cell_size = cell_size);
+     }
+
+    /**
+     * @brief Returns the mesh criteria for a mesh resolution, where the size criteria are only applied
+     *        inside a bounding box, @see resolution_criteria.
+     * @param bounding_sphere_radius the radius of the minimum bounding sphere of the surfaces.
+     * @param mesh_resolution the mesh resolution.
+     * @param bbox the bounding box, e.g. of the remeshed region.
+     * @returns the mesh criteria.
+     */
+     static Mesh_criteria local_resolution_criteria(double bounding_sphere_radius, double mesh_resolution, const CGAL::Bbox_3& bbox)
+     {
+        const double cell_size = bounding_sphere_radius/mesh_resolution;
+        // Outside the box, the sizes are the diameter of the bounding sphere, i.e. not restrictive.
+        Region_sizing_field size{bbox, cell_size, 2*bounding_sphere_radius};
+        Region_sizing_field distance{bbox, cell_size/10.0, 2*bounding_sphere_radius};
+        return Mesh_criteria(CGAL::parameters::edge_size = size,
+                             CGAL::parameters::facet_angle = 30.0,
+                             CGAL::parameters::facet_size = size,
+                             CGAL::parameters::facet_distance = distance, 
+                             CGAL::parameters::cell_radius_edge_ratio = 3.0,
+                             CGAL::parameters::cell_size = size);
+     }
+
+    /**
+     * @brief Estimates the memory of a polyhedral mesh domain, i.e. a copy of the polyhedron 
+     *        and the AABB tree of its facets.
+     * @param polyhedron the polyhedron used to construct the polyhedral mesh domain.
+     * @returns the estimated number of bytes.
+     */
+     static std::size_t polyhedral_domain_memory_usage(const Polyhedron& polyhedron)
+     {
+        std::size_t facets = polyhedron.size_of_facets();
+        return polyhedron.size_of_vertices()*sizeof(Polyhedron::Vertex)
+             + polyhedron.size_of_halfedges()*sizeof(Polyhedron::Halfedge)
+             + facets*sizeof(Polyhedron::Facet)
+             + facets*(sizeof(Polyhedron::Facet_handle)+sizeof(Point_3))
+             + facets*(sizeof(CGAL::Bbox_3)+2*sizeof(void*));
+     }
 
-   private :  
      std::vector<std::pair<Triangle_3,double>> triangle_data;
      std::vector<std::pair<Point_3,double>> point_data;     
      
      Function_vector v; 
      std::shared_ptr<AbstractMap> map_ptr;
      std::unique_ptr<Mesh_domain> domain_ptr;
+     bool features_registered = false;
+     std::shared_ptr<QueryCounters> counters = std::make_shared<QueryCounters>();
      Minimum_sphere<Kernel> min_sphere; 
+     std::size_t polyhedral_domain_bytes = 0;
+     std::size_t number_of_input_surfaces = 0;
+     bool finalized = false;
+     bool regular = true;
+     bool completed = true;
+     bool verbose = true;
+     std::vector<int> cell_partition;
+     std::vector<Cell_handle> partition_cells;
+     int number_of_parts = 0;
+     std::string output_ordering = "none";
+     mutable std::vector<Vertex_handle> output_vertices;
+     mutable std::vector<Cell_handle> output_cells;
+     mutable bool has_output_order = false;
+     std::map<std::string,Data_field> data_fields;
+     std::vector<Vertex_handle> data_vertices;
+     std::vector<Cell_handle> data_cells;
+     std::vector<Facet> data_facets;
+     std::vector<std::vector<Point_3>> reference_points;
+     std::vector<std::vector<Face>> reference_faces;
+     std::shared_ptr<Region_of_interest> roi;
+     double error_bound = 1.e-7;
      C3t3 c3t3;
      Polylines borders;
      Polylines features;
@@ -0,0 +1,495 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Graph_partition_H
+
+#define Graph_partition_H
+/* --- Includes -- */
+#include "Errors.h"                                 // for InvalidArgumentError, AlgorithmError
+
+/* -- STL -- */
+#include <algorithm>                                // for shuffle, max, min
+#include <cmath>                                    // for pow
+#include <cstddef>                                  // for size_t
+#include <numeric>                                  // for iota, accumulate
+#include <queue>                                    // for queue
+#include <random>                                   // for mt19937
+#include <vector>                                   // for vector
+
+#ifdef SVMTK_USE_METIS
+#include <metis.h>
+#endif
+
+/**
+ * \struct CSR_graph
+ * Undirected weighted graph in compressed sparse row format, as used by METIS.
+ * The neighbours of vertex i are adjacency[offsets[i]] ... adjacency[offsets[i+1]-1],
+ * and each edge is stored in both directions.
+ */
+struct CSR_graph
+{
+    std::vector<std::size_t> offsets{0};
+    std::vector<std::size_t> adjacency;
+    std::vector<long> edge_weights;
+    std::vector<long> vertex_weights;
+
+    std::size_t size() const { return vertex_weights.size(); }
+};
+
+/**
+ * @brief Returns the sum of the weights of edges between different parts.
+ * @param graph CSR_graph object.
+ * @param parts the part of each vertex.
+ * @returns the edge cut.
+ */
+inline long edge_cut(const CSR_graph& graph, const std::vector<int>& parts)
+{
+    long cut = 0;
+    for(std::size_t i = 0; i < graph.size(); ++i)
+       for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+          if( parts[i]!=parts[graph.adjacency[j]] )
+            cut += graph.edge_weights[j];
+    return cut/2;
+}
+
+/**
+ * @brief Coarsens a graph by heavy edge matching.
+ * @param graph the fine graph.
+ * @param coarse_map[out] the coarse vertex of each fine vertex.
+ * @param random random number generator used to visit the vertices in random order.
+ * @returns the coarse graph.
+ */
+inline CSR_graph coarsen_graph(const CSR_graph& graph, std::vector<std::size_t>& coarse_map, std::mt19937& random)
+{
+    const std::size_t none = graph.size();
+    std::vector<std::size_t> order(graph.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<std::size_t> match(graph.size(), none);
+    for(std::size_t i : order)
+    {
+       if( match[i]!=none )
+         continue;
+       std::size_t best = i;
+       long best_weight = -1;
+       for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+       {
+          std::size_t k = graph.adjacency[j];
+          if( match[k]==none and k!=i and graph.edge_weights[j]>best_weight )
+          {
+            best = k;
+            best_weight = graph.edge_weights[j];
+          }
+       }
+       match[i] = best;
+       match[best] = i;
+    }
+
+    coarse_map.assign(graph.size(), none);
+    std::size_t n = 0;
+    for(std::size_t i : order)
+    {
+       if( coarse_map[i]!=none )
+         continue;
+       coarse_map[i] = n;
+       coarse_map[match[i]] = n;
+       ++n;
+    }
+
+    std::vector<std::vector<std::size_t>> members(n);
+    for(std::size_t i = 0; i < graph.size(); ++i)
+       members[coarse_map[i]].push_back(i);
+
+    CSR_graph coarse;
+    coarse.vertex_weights.assign(n, 0);
+    std::vector<long> marker(n, -1);
+    for(std::size_t c = 0; c < n; ++c)
+    {
+       std::size_t begin = coarse.adjacency.size();
+       for(std::size_t i : members[c])
+       {
+          coarse.vertex_weights[c] += graph.vertex_weights[i];
+          for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+          {
+             std::size_t k = coarse_map[graph.adjacency[j]];
+             if( k==c )
+               continue;
+             if( marker[k]<static_cast<long>(begin) )
+             {
+               marker[k] = coarse.adjacency.size();
+               coarse.adjacency.push_back(k);
+               coarse.edge_weights.push_back(graph.edge_weights[j]);
+             }
+             else
+               coarse.edge_weights[marker[k]] += graph.edge_weights[j];
+          }
+       }
+       coarse.offsets.push_back(coarse.adjacency.size());
+    }
+    return coarse;
+}
+
+/**
+ * @brief Improves a bisection with Fiduccia-Mattheyses refinement.
+ *
+ * Each pass moves boundary vertices one at a time in order of decreasing gain, also
+ * when the gain is negative, and keeps the prefix of moves with the smallest edge cut
+ * that satisfies the balance. A vertex is moved at most once per pass.
+ * @param graph the graph.
+ * @param parts[in,out] the part, 0 or 1, of each vertex.
+ * @param max_weight the maximum allowed weight of each part.
+ * @param passes the maximum number of refinement passes.
+ */
+inline void refine_bisection(const CSR_graph& graph, std::vector<int>& parts, const long max_weight[2], int passes=8)
+{
+    long weight[2] = {0, 0};
+    for(std::size_t i = 0; i < graph.size(); ++i)
+       weight[parts[i]] += graph.vertex_weights[i];
+    auto balanced = [&]() { return weight[0]<=max_weight[0] and weight[1]<=max_weight[1]; };
+    auto imbalance = [&]() { return std::max(weight[0]-max_weight[0], 0L) + std::max(weight[1]-max_weight[1], 0L); };
+
+    std::vector<long> gain(graph.size());
+    std::vector<char> locked(graph.size());
+    const std::size_t max_idle_moves = 100;
+    for(int pass = 0; pass < passes; ++pass)
+    {
+       std::priority_queue<std::pair<long,std::size_t>> queue;
+       std::fill(locked.begin(), locked.end(), 0);
+       for(std::size_t i = 0; i < graph.size(); ++i)
+       {
+          long external = 0, internal = 0;
+          for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+             ( parts[graph.adjacency[j]]==parts[i] ? internal : external ) += graph.edge_weights[j];
+          gain[i] = external - internal;
+          if( external>0 or !balanced() )
+            queue.push(std::make_pair(gain[i], i));
+       }
+
+       std::vector<std::size_t> moves;
+       long total_gain = 0, best_gain = 0;
+       long best_imbalance = imbalance();
+       std::size_t best_moves = 0;
+       while( !queue.empty() and moves.size()-best_moves<max_idle_moves )
+       {
+          std::pair<long,std::size_t> top = queue.top();
+          queue.pop();
+          std::size_t i = top.second;
+          if( locked[i] or top.first!=gain[i] )
+            continue;
+          int from = parts[i], to = 1 - from;
+          // Moves may only overload a part if they reduce the imbalance.
+          if( weight[to] + graph.vertex_weights[i]>max_weight[to] and weight[from]<=max_weight[from] )
+            continue;
+          if( weight[to] + graph.vertex_weights[i]>max_weight[to] and weight[to] + graph.vertex_weights[i]>=weight[from] )
+            continue;
+
+          locked[i] = 1;
+          parts[i] = to;
+          weight[from] -= graph.vertex_weights[i];
+          weight[to] += graph.vertex_weights[i];
+          total_gain += gain[i];
+          gain[i] = -gain[i];
+          moves.push_back(i);
+          for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+          {
+             std::size_t k = graph.adjacency[j];
+             gain[k] += ( parts[k]==to ? -2 : 2 )*graph.edge_weights[j];
+             if( !locked[k] )
+               queue.push(std::make_pair(gain[k], k));
+          }
+          long current_imbalance = imbalance();
+          if( current_imbalance<best_imbalance or ( current_imbalance==best_imbalance and total_gain>best_gain ) )
+          {
+            best_imbalance = current_imbalance;
+            best_gain = total_gain;
+            best_moves = moves.size();
+          }
+       }
+
+       for(std::size_t m = moves.size(); m-- > best_moves; )
+       {
+          std::size_t i = moves[m];
+          weight[parts[i]] -= graph.vertex_weights[i];
+          parts[i] = 1 - parts[i];
+          weight[parts[i]] += graph.vertex_weights[i];
+       }
+       if( best_moves==0 )
+         break;
+    }
+}
+
+/**
+ * @brief Bisects a small graph by greedy graph growing from a few seed vertices,
+ *        and keeps the bisection with the smallest edge cut.
+ * @param graph the graph.
+ * @param target the target weight of part 0.
+ * @param max_weight the maximum allowed weight of each part.
+ * @param random random number generator used to select the seed vertices.
+ * @returns the part, 0 or 1, of each vertex.
+ */
+inline std::vector<int> grow_bisection(const CSR_graph& graph, long target, const long max_weight[2], std::mt19937& random)
+{
+    std::vector<int> best;
+    long best_cut = -1;
+    for(int trial = 0; trial < 4; ++trial)
+    {
+       std::vector<int> parts(graph.size(), 1);
+       long weight = 0;
+       std::uniform_int_distribution<std::size_t> seed(0, graph.size()-1);
+       std::queue<std::size_t> front;
+       std::size_t next_unvisited = 0;
+       front.push(seed(random));
+       while( weight<target )
+       {
+          if( front.empty() )
+          {
+            // Disconnected graph, continue from an unvisited vertex.
+            while( next_unvisited<graph.size() and parts[next_unvisited]==0 )
+               ++next_unvisited;
+            if( next_unvisited==graph.size() )
+              break;
+            front.push(next_unvisited);
+          }
+          std::size_t i = front.front();
+          front.pop();
+          if( parts[i]==0 )
+            continue;
+          parts[i] = 0;
+          weight += graph.vertex_weights[i];
+          for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+             if( parts[graph.adjacency[j]]==1 )
+               front.push(graph.adjacency[j]);
+       }
+       refine_bisection(graph, parts, max_weight);
+       long cut = edge_cut(graph, parts);
+       if( best_cut<0 or cut<best_cut )
+       {
+         best_cut = cut;
+         best = parts;
+       }
+    }
+    return best;
+}
+
+/**
+ * @brief Multilevel bisection, i.e. the graph is coarsened by heavy edge matching,
+ *        bisected by greedy graph growing, and the bisection is projected back
+ *        and refined on each level.
+ * @param graph the graph.
+ * @param fraction the target fraction of the total vertex weight in part 0.
+ * @param imbalance the allowed ratio between the weight and the target weight of a part.
+ * @param random random number generator.
+ * @returns the part, 0 or 1, of each vertex.
+ */
+inline std::vector<int> multilevel_bisection(const CSR_graph& graph, double fraction, double imbalance, std::mt19937& random)
+{
+    long total = std::accumulate(graph.vertex_weights.begin(), graph.vertex_weights.end(), 0L);
+    long target = static_cast<long>(fraction*total + 0.5);
+    long max_weight[2] = { static_cast<long>(imbalance*target) + 1, static_cast<long>(imbalance*(total-target)) + 1 };
+
+    std::vector<CSR_graph> levels;
+    std::vector<std::vector<std::size_t>> maps;
+    const CSR_graph* current = &graph;
+    while( current->size()>64 )
+    {
+       std::vector<std::size_t> coarse_map;
+       CSR_graph coarse = coarsen_graph(*current, coarse_map, random);
+       if( coarse.size()>0.9*current->size() )
+         break;
+       maps.push_back(std::move(coarse_map));
+       levels.push_back(std::move(coarse));
+       current = &levels.back();
+    }
+
+    std::vector<int> parts = grow_bisection(*current, target, max_weight, random);
+    for(std::size_t level = levels.size(); level-- > 0; )
+    {
+       const CSR_graph& fine = level==0 ? graph : levels[level-1];
+       std::vector<int> fine_parts(fine.size());
+       for(std::size_t i = 0; i < fine.size(); ++i)
+          fine_parts[i] = parts[maps[level][i]];
+       parts.swap(fine_parts);
+       refine_bisection(fine, parts, max_weight);
+    }
+    return parts;
+}
+
+/**
+ * @brief Partitions a graph recursively with multilevel bisection.
+ * @param graph the graph.
+ * @param vertices the vertices of the graph to partition.
+ * @param num_parts the number of parts.
+ * @param first_part the index of the first part.
+ * @param imbalance the allowed ratio between the weight and the target weight of a part.
+ * @param parts[out] the part of each vertex.
+ * @param random random number generator.
+ */
+inline void recursive_bisection(const CSR_graph& graph, const std::vector<std::size_t>& vertices, int num_parts, int first_part,
+                                double imbalance, std::vector<int>& parts, std::mt19937& random)
+{
+    if( num_parts==1 or vertices.size()<=1 )
+    {
+      for(std::size_t i : vertices)
+         parts[i] = first_part;
+      return;
+    }
+    std::vector<std::size_t> local(graph.size(), graph.size());
+    for(std::size_t i = 0; i < vertices.size(); ++i)
+       local[vertices[i]] = i;
+
+    CSR_graph subgraph;
+    for(std::size_t i : vertices)
+    {
+       subgraph.vertex_weights.push_back(graph.vertex_weights[i]);
+       for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+          if( local[graph.adjacency[j]]<graph.size() )
+          {
+            subgraph.adjacency.push_back(local[graph.adjacency[j]]);
+            subgraph.edge_weights.push_back(graph.edge_weights[j]);
+          }
+       subgraph.offsets.push_back(subgraph.adjacency.size());
+    }
+
+    int left_parts = num_parts/2;
+    std::vector<int> bisection = multilevel_bisection(subgraph, double(left_parts)/num_parts, imbalance, random);
+    std::vector<std::size_t> left, right;
+    for(std::size_t i = 0; i < vertices.size(); ++i)
+       ( bisection[i]==0 ? left : right ).push_back(vertices[i]);
+    recursive_bisection(graph, left, left_parts, first_part, imbalance, parts, random);
+    recursive_bisection(graph, right, num_parts-left_parts, first_part+left_parts, imbalance, parts, random);
+}
+
+/**
+ * @brief Partitions a graph into parts of balanced vertex weight with small edge cut.
+ *
+ * Uses METIS_PartGraphKway if SVMTK is built with SVMTK_USE_METIS, and otherwise
+ * recursive multilevel bisection.
+ * @param graph the graph.
+ * @param num_parts the number of parts.
+ * @param imbalance the allowed ratio between the weight and the average weight of a part.
+ * @returns the part of each vertex.
+ * @throws InvalidArgumentError if num_parts is not positive.
+ */
+inline std::vector<int> partition_graph(const CSR_graph& graph, int num_parts, double imbalance=1.03)
+{
+    if( num_parts<1 )
+      throw InvalidArgumentError("Number of parts must be positive.");
+    std::vector<int> parts(graph.size(), 0);
+    if( num_parts==1 or graph.size()==0 )
+      return parts;
+#ifdef SVMTK_USE_METIS
+    idx_t nvtxs = graph.size(), ncon = 1, nparts = num_parts, objval;
+    std::vector<idx_t> xadj(graph.offsets.begin(), graph.offsets.end());
+    std::vector<idx_t> adjncy(graph.adjacency.begin(), graph.adjacency.end());
+    std::vector<idx_t> adjwgt(graph.edge_weights.begin(), graph.edge_weights.end());
+    std::vector<idx_t> vwgt(graph.vertex_weights.begin(), graph.vertex_weights.end());
+    std::vector<idx_t> part(graph.size());
+    real_t ubvec = imbalance;
+    if( METIS_PartGraphKway(&nvtxs, &ncon, xadj.data(), adjncy.data(), vwgt.data(), nullptr, adjwgt.data(),
+                            &nparts, nullptr, &ubvec, nullptr, &objval, part.data())!=METIS_OK )
+      throw AlgorithmError("METIS partitioning failed.");
+    parts.assign(part.begin(), part.end());
+#else
+    // The imbalance is compounded over the levels of the recursion.
+    int depth = 0;
+    for(int n = 1; n < num_parts; n *= 2)
+       ++depth;
+    double level_imbalance = std::pow(imbalance, 1.0/depth);
+    std::mt19937 random(5489u);
+    std::vector<std::size_t> vertices(graph.size());
+    std::iota(vertices.begin(), vertices.end(), 0);
+    recursive_bisection(graph, vertices, num_parts, 0, level_imbalance, parts, random);
+#endif
+    return parts;
+}
+
+/**
+ * @brief Orders the vertices of a graph with reverse Cuthill-McKee, which reduces the bandwidth
+ *        of the adjacency matrix, and improves the memory locality of neighbouring vertices.
+ *
+ * Each connected component is ordered by breadth first search from a pseudo-peripheral vertex,
+ * visiting the neighbours in order of increasing degree.
+ * @param graph the graph.
+ * @returns the vertices in the new order.
+ */
+inline std::vector<std::size_t> reverse_cuthill_mckee(const CSR_graph& graph)
+{
+    const std::size_t n = graph.size();
+    auto degree = [&](std::size_t i) { return graph.offsets[i+1] - graph.offsets[i]; };
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<std::size_t> stamp(n, 0);
+    std::size_t current_stamp = 0;
+
+    // Returns the vertex of minimum degree in the last level of a breadth first search.
+    auto farthest = [&](std::size_t start)
+    {
+       ++current_stamp;
+       std::vector<std::size_t> level{start}, next;
+       stamp[start] = current_stamp;
+       std::size_t result = start;
+       while( !level.empty() )
+       {
+          result = level.front();
+          for(std::size_t i : level)
+             if( degree(i)<degree(result) )
+               result = i;
+          next.clear();
+          for(std::size_t i : level)
+             for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+                if( stamp[graph.adjacency[j]]!=current_stamp )
+                {
+                  stamp[graph.adjacency[j]] = current_stamp;
+                  next.push_back(graph.adjacency[j]);
+                }
+          level.swap(next);
+       }
+       return result;
+    };
+
+    std::vector<std::size_t> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&](std::size_t a, std::size_t b) { return degree(a)<degree(b); });
+    std::vector<std::size_t> neighbours;
+    for(std::size_t seed : by_degree)
+    {
+       if( visited[seed] )
+         continue;
+       std::size_t start = farthest(farthest(seed));
+       std::size_t head = order.size();
+       order.push_back(start);
+       visited[start] = 1;
+       while( head<order.size() )
+       {
+          std::size_t i = order[head++];
+          neighbours.clear();
+          for(std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+             if( !visited[graph.adjacency[j]] )
+             {
+               visited[graph.adjacency[j]] = 1;
+               neighbours.push_back(graph.adjacency[j]);
+             }
+          std::stable_sort(neighbours.begin(), neighbours.end(), [&](std::size_t a, std::size_t b) { return degree(a)<degree(b); });
+          order.insert(order.end(), neighbours.begin(), neighbours.end());
+       }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Parallel_H
+
+#define Parallel_H
+/* --- Includes -- */
+#include "Cancellation.h"                           // for CancellationToken
+
+#include <algorithm>                                // for min, max
+#include <atomic>                                   // for atomic
+#include <cstddef>                                  // for size_t
+#include <exception>                                // for exception_ptr
+#include <mutex>                                    // for mutex, lock_guard
+#include <thread>                                   // for thread
+#include <vector>                                   // for vector
+
+/**
+ * @brief Returns the number of threads used for a number of tasks.
+ * @param num_threads the requested number of threads, non-positive uses the number of hardware threads.
+ * @param tasks the number of tasks.
+ * @returns the number of threads, at least one and at most the number of tasks.
+ */
+inline std::size_t thread_count(int num_threads, std::size_t tasks)
+{
+   std::size_t result = num_threads>0 ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+   return std::max<std::size_t>(1, std::min(result, tasks));
+}
+
+/**
+ * @brief Calls function(i) for each i in [0, n), where the indices are taken in order by a pool of threads.
+ *
+ * The CancellationToken that is active on the calling thread is active on the threads. If the function
+ * throws, the remaining indices are still processed, and the first exception is rethrown after the
+ * threads are joined. With a single thread, the function is called on the calling thread.
+ * @param n the number of indices.
+ * @param num_threads the number of threads, non-positive uses the number of hardware threads, @see thread_count.
+ * @param function the function called with each index, which must be safe to call concurrently.
+ */
+template<typename Function>
+void parallel_for(std::size_t n, int num_threads, Function function)
+{
+   if( n==0 )
+     return;
+   std::atomic<std::size_t> next{0};
+   std::exception_ptr error = nullptr;
+   std::mutex error_mutex;
+   auto worker = [&]()
+   {
+      for(std::size_t i = next++; i < n; i = next++)
+      {
+         try
+         {
+            function(i);
+         }
+         catch(...)
+         {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if( !error )
+              error = std::current_exception();
+         }
+      }
+   };
+
+   std::size_t number_of_threads = thread_count(num_threads, n);
+   if( number_of_threads==1 )
+     worker();
+   else
+   {
+     CancellationToken* token = CancellationToken::current();
+     std::vector<std::thread> threads;
+     for(std::size_t i = 0; i < number_of_threads; ++i)
+        threads.emplace_back([&]()
+        {
+           CancellationToken::current() = token;
+           worker();
+           CancellationToken::current() = nullptr;
+        });
+     for(auto& thread : threads)
+        thread.join();
+   }
+   if( error )
+     std::rethrow_exception(error);
+}
+
+#endif
@@ -4,6 +4,10 @@
 
 /* --- Includes -- */
 #include "SubdomainMap.h" 
+#include "Counters.h"
+
+/* -- STL -- */
+#include <functional>
 
 
 
@@ -30,13 +34,26 @@ namespace CGAL {
                  * @param v a vector of functions i.e. surfaces with query is inside  
                  * @param map a smart pointer to a child class of SVMTK virtuell class AbstractMap
                  *       options : DefaultMap and SubdomainMap
+                 * @param counters optional query counters, incremented for each evaluation.
                  */
-                Polyhedral_vector_to_labeled_function_wrapper(const std::vector<Function_*>& v, std::shared_ptr<AbstractMap> map) : function_vector_(v)
+                Polyhedral_vector_to_labeled_function_wrapper(const std::vector<Function_*>& v, std::shared_ptr<AbstractMap> map,
+                                                              std::shared_ptr<QueryCounters> counters = nullptr) : function_vector_(v)
                 {
                     subdmap =std::move(map);
+                    this->counters = std::move(counters);
                 }
 
                 ~Polyhedral_vector_to_labeled_function_wrapper() {}
+
+               /**
+                 * @brief Restricts the labeling to a region, so that points outside the region get 
+                 *        label 0 without evaluating the surfaces.
+                 * @param region returns true for points inside the region, or an empty function for no restriction.
+                 */
+                void set_region(std::function<bool(const Point_3&)> region)
+                {
+                    this->region = std::move(region);
+                }
                 
                /**
                  * @brief operator that returns the subdomain tag during construction of the mesh.
@@ -53,11 +70,22 @@ namespace CGAL {
                  */
                 return_type operator()(const Point_3& p, bool use_cache = false) const
                 {
+                    if( region and !region(p) )
+                    {
+                      if( counters )
+                        counters->increment(QueryCounters::LABELING_CALLS);
+                      return 0;
+                    }
                     int nb_func = function_vector_.size();
                     Bmask bits(nb_func);
 
                     for(int i=0; i<nb_func; ++i)
                         bits[i] =(bool)function_vector_[i]->is_in_domain_object()(p);
+                    if( counters )
+                    {
+                      counters->increment(QueryCounters::LABELING_CALLS);
+                      counters->increment(QueryCounters::IS_IN_DOMAIN_EVALUATIONS, nb_func);
+                    }
                     return subdmap->index(bits);
                 }
                 
@@ -80,6 +108,8 @@ namespace CGAL {
             private:
                 Function_vector function_vector_;
                 std::shared_ptr<AbstractMap> subdmap;
+                std::shared_ptr<QueryCounters> counters;
+                std::function<bool(const Point_3&)> region;
         };
 }
 
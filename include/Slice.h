@@ -592,6 +592,104 @@ class Slice
       }
       
 
+     /** 
+      * @brief Replaces the 2D mesh with a tagged triangulation of convex polygons, e.g. the sections of 
+      *        the cells of a tetrahedral mesh. The polygon edges are inserted as constraints, the faces 
+      *        of each polygon get the tag of the polygon, and faces outside all polygons are removed.
+      *        The edges between faces with different tags get the tag of the tag pair in the interface map,
+      *        or a new tag if the pair is not in the map.
+      * @param points the polygon vertices in the plane of the slice.
+      * @param polygons the convex polygons as counterclockwise indices into points.
+      * @param polygon_tags the tag of each polygon.
+      * @param interfaces map from pairs of tags (larger, smaller) to edge tags.
+      */
+      void set_mesh(const Polyline_2& points, const std::vector<std::vector<std::size_t>>& polygons, 
+                    const std::vector<int>& polygon_tags, std::map<std::pair<int,int>,int> interfaces)
+      {
+         cdt.clear();
+         edges.clear();
+         min_sphere.add_polyline(points);
+         std::vector<Vertex_handle> vertices;
+         vertices.reserve(points.size());
+         Face_handle hint;
+         for(const Point_2& point : points)
+         {
+            Vertex_handle vh = cdt.insert(point, hint);
+            hint = vh->face();
+            vertices.push_back(vh);
+         }
+         std::set<std::pair<std::size_t,std::size_t>> segments;
+         for(auto const& polygon : polygons)
+            for(std::size_t i = 0; i < polygon.size(); ++i)
+               segments.insert(std::minmax(polygon[i], polygon[(i+1)%polygon.size()]));
+         for(auto const& segment : segments)
+            if( vertices[segment.first]!=vertices[segment.second] )
+              cdt.insert_constraint(vertices[segment.first], vertices[segment.second]);
+
+         for(Face_iterator fit = cdt.all_faces_begin(); fit != cdt.all_faces_end(); ++fit)
+         {
+            fit->info() = 0;
+            for(int i = 0; i < 3; ++i)
+               fit->vertex(i)->info() = 0;
+         }
+         for(std::size_t k = 0; k < polygons.size(); ++k)
+         {
+            double x = 0, y = 0;
+            for(std::size_t i : polygons[k])
+            {
+               x += points[i].x();
+               y += points[i].y();
+            }
+            Face_handle start = cdt.locate(Point_2(x/polygons[k].size(), y/polygons[k].size()), hint);
+            if( start==Face_handle() )
+              continue;
+            hint = start;
+            std::vector<Face_handle> queue{start};
+            std::set<Face_handle> visited;
+            while( !queue.empty() )
+            {
+               Face_handle fh = queue.back();
+               queue.pop_back();
+               if( cdt.is_infinite(fh) or !visited.insert(fh).second )
+                 continue;
+               fh->info() = polygon_tags[k];
+               for(int i = 0; i < 3; ++i)
+                  if( !cdt.is_constrained(Edge(fh,i)) )
+                    queue.push_back(fh->neighbor(i));
+            }
+         }
+
+         int next_tag = 1;
+         for(auto const& tag_pair : interfaces)
+            next_tag = std::max(next_tag, tag_pair.second+1);
+         std::vector<Face_handle> removed;
+         for(Face_iterator fit = cdt.finite_faces_begin(); fit != cdt.finite_faces_end(); ++fit)
+         {
+            int fi = fit->info();
+            fit->set_in_domain(fi!=0);
+            if( fi==0 )
+            {
+              removed.push_back(fit);
+              continue;
+            }
+            for(int i = 0; i < 3; ++i)
+            {
+               int fn = cdt.is_infinite(fit->neighbor(i)) ? 0 : fit->neighbor(i)->info();
+               if( fn==fi )
+               {
+                 this->edges[Edge(fit,i)] = 0;
+                 continue;
+               }
+               std::pair<int,int> key(std::max(fi,fn), std::min(fi,fn));
+               if( interfaces.insert(std::make_pair(key, next_tag)).second )
+                 next_tag++;
+               this->edges[Edge(fit,i)] = interfaces[key];
+            }
+         }
+         for(Face_handle fh : removed)
+            cdt.delete_face(fh);
+      }
+
      /** 
       * @brief Adds constraints to the CGAL triangulation object cdt.
       */
@@ -257,7 +257,9 @@ class SubdomainMap :virtual public AbstractMap
         */
         return_type index(const Bmask bits) 
         {
-           return static_cast<return_type>(subdmap[bits]);  
+           // Lookup without insertion, so that meshing does not modify the map. 
+           auto it = subdmap.find(bits);
+           return static_cast<return_type>( it==subdmap.end() ? 0 : it->second );  
         }
         
         // DocString: print    
@@ -28,6 +28,9 @@
 /* --Includes -- */
 #include "surface_mesher.h" 
 #include "Errors.h" //FIXME 
+#include "Timer.h"
+#include "Counters.h"
+#include "Cancellation.h"
 
 /* -- boost-- */
 #include <boost/foreach.hpp>
@@ -564,6 +567,7 @@ class Surface
    */
    void reconstruct(double angular_bound=20, double radius_bound=0.1, double distance_bound=0.1)
    { 
+      ScopedTimer timer("Surface::reconstruct");
       assert_non_empty_mesh();
       poisson_reconstruction(*this,angular_bound, radius_bound, distance_bound);
    }
@@ -588,6 +592,7 @@ class Surface
    */
    std::vector<std::pair<Triangle_3 , std::pair<int,int>>> surface_segmentation(int nb_of_patch_plus_one=1, double angle_in_degree=85)
    {
+     ScopedTimer timer("Surface::surface_segmentation");
      //typedef boost::property_map<Mesh,CGAL::edge_is_feature_t>::type EIFMap; 
      EIFMap eif = get(CGAL::edge_is_feature, mesh);
     
@@ -615,6 +620,8 @@ class Surface
          Triangle_3 tri(p1,p2,p3); 
          Tri2tagvec.push_back(std::make_pair(tri,get(patch_id_map,f)));     
      }
+     mesh.remove_property_map(patch_id_map);
+     mesh.remove_property_map(vertex_incident_patch_map);
      return Tri2tagvec;
    }
 
@@ -655,6 +662,7 @@ class Surface
    */
    std::pair<bool,int> repair_self_intersections(double volume_threshold=0.01, double cap_threshold=170, double needle_threshold=2.7, double collapse_threshold=0.14)
    {
+        ScopedTimer timer("Surface::repair_self_intersections");
         double avgel = average_edge_length();
         CGAL::Polygon_mesh_processing::remove_isolated_vertices(mesh);
                
@@ -740,9 +748,11 @@ class Surface
    {
       assert_non_empty_mesh();
       Inside is_inside_query(other.get_mesh()); 
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS);
       for(auto vit = mvertices.begin(); vit!= mvertices.end(); )
       {
          CGAL::Bounded_side res = is_inside_query(mesh.point(vit->first));
+         counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_QUERIES);
          if( res==A or res==B )
            vit++;
          else 
@@ -767,9 +777,11 @@ class Surface
    {
       assert_non_empty_mesh();
       Inside is_inside_query(other.get_mesh()); 
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS);
       for(auto vit = vertices.begin(); vit!= vertices.end(); )
       {
          CGAL::Bounded_side res =  is_inside_query(mesh.point(*vit));
+         counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_QUERIES);
          if( res==A or res==B )
            vit++;
          else 
@@ -812,9 +824,11 @@ class Surface
       assert_non_empty_mesh();
       bool query1 = false, query2 = false; 
       Inside is_inside_query(other.get_mesh()); 
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS);
       for(vertex_descriptor vit : mesh.vertices() )
       {
          CGAL::Bounded_side res =  is_inside_query(mesh.point(vit));
+         counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_QUERIES);
          if( res==A )                                
             query1 = true;
          if( res==B )
@@ -968,6 +982,7 @@ class Surface
                  vertices(other.get_mesh()).end(),
                  Splitter(),
                  Traits(vppmap));
+       counters.increment(QueryCounters::KD_TREE_CONSTRUCTIONS);
  
        Distance tr_dist(vppmap);
        FT distance, edgeL;
@@ -978,6 +993,7 @@ class Surface
        {
           flag = true;
           K_neighbor_search search(tree, mesh.point(*vit), 2,0,true,tr_dist); 
+          counters.increment(QueryCounters::NEAREST_NEIGHBOUR_SEARCHES);
           closest = other.get_mesh().point((search.begin()+A)->first);
           Point_3 current = mesh.point(*vit);
           direction =  Vector_3(closest,current);
@@ -1027,6 +1043,7 @@ class Surface
                  vertices(other.get_mesh()).end(),
                  Splitter(),
                  Traits(vppmap));
+       counters.increment(QueryCounters::KD_TREE_CONSTRUCTIONS);
 
        Distance tr_dist(vppmap);
 
@@ -1038,6 +1055,7 @@ class Surface
        {
            flag = true;
            K_neighbor_search search(tree, mesh.point(vit), 2,0,true,tr_dist); 
+           counters.increment(QueryCounters::NEAREST_NEIGHBOUR_SEARCHES);
            closest = other.get_mesh().point((search.begin()+A)->first); 
            Point_3 current = mesh.point(vit);
            direction = Vector_3(closest,current);
@@ -1081,6 +1099,7 @@ class Surface
                  vertices(other.get_mesh()).end(),
                  Splitter(),
                  Traits(vppmap));
+       counters.increment(QueryCounters::KD_TREE_CONSTRUCTIONS);
 
        Distance tr_dist(vppmap);
 
@@ -1092,6 +1111,7 @@ class Surface
        {
            flag = true;
            K_neighbor_search search(tree, mesh.point(vit->first), 2,0,true,tr_dist); 
+           counters.increment(QueryCounters::NEAREST_NEIGHBOUR_SEARCHES);
            closest = other.get_mesh().point((search.begin()+A)->first); 
            Point_3 current = mesh.point(vit->first);
            direction = Vector_3(closest,current);
@@ -1133,6 +1153,7 @@ class Surface
     */  
     std::pair<bool,int> separate_narrow_gaps(double adjustment, double smoothing, int max_iter)  
     {
+       ScopedTimer timer("Surface::separate_narrow_gaps");
        assert_non_empty_mesh();
        CGAL::Polygon_mesh_processing::remove_isolated_vertices(mesh); 
        if( adjustment>0 )
@@ -1153,6 +1174,7 @@ class Surface
    */
    std::pair<bool,int> separate_close_vertices(double adjustment, int max_iter) 
    {
+      ScopedTimer timer("Surface::separate_close_vertices");
       assert_non_empty_mesh();
       double smoothing = 0.5*adjustment;
       CGAL::Polygon_mesh_processing::remove_isolated_vertices(mesh); 
@@ -1175,6 +1197,7 @@ class Surface
    */
    std::pair<bool,int> embed(Surface& other, double adjustment=-0.5,  double smoothing=0.3, int max_iter=400) 
    {
+      ScopedTimer timer("Surface::embed");
       assert_non_empty_mesh();
       CGAL::Polygon_mesh_processing::remove_isolated_vertices(mesh); 
       if( adjustment>=0 )
@@ -1196,6 +1219,7 @@ class Surface
    */
    std::pair<bool,int> enclose(Surface& other, double adjustment=0.5,double smoothing=-0.3, int max_iter=400) 
    {
+      ScopedTimer timer("Surface::enclose");
       assert_non_empty_mesh();
       CGAL::Polygon_mesh_processing::remove_isolated_vertices(mesh); 
       if( adjustment<=0 )
@@ -1217,6 +1241,7 @@ class Surface
    */
    std::pair<bool,int> expose(Surface& other, double adjustment=-0.5,  double smoothing=0.1, int max_iter=400) 
    {
+     ScopedTimer timer("Surface::expose");
      if( adjustment>=0 )
          throw InvalidArgumentError("Adjusment must be negative.");
      return manipulate_vertex_selection<CGAL::ON_BOUNDED_SIDE,CGAL::ON_BOUNDARY>(other, adjustment, smoothing, max_iter);
@@ -1234,6 +1259,7 @@ class Surface
    */
    std::pair<bool,int> separate(Surface& other, double adjustment=0.5, double smoothing=0.1, int max_iter=400)
    { 
+      ScopedTimer timer("Surface::separate");
       std::pair<bool,bool> queries = check_vertices<CGAL::ON_BOUNDED_SIDE,CGAL::ON_UNBOUNDED_SIDE>(other);
       if( queries.first==queries.second )
          throw InvalidArgumentError("Surfaces must not collide.");
@@ -1306,6 +1332,7 @@ class Surface
    */
    bool surface_intersection(Surface other)
    {
+      ScopedTimer timer("Surface::surface_intersection");
       assert_non_empty_mesh();
       other.assert_non_empty_mesh();
       try
@@ -1331,6 +1358,7 @@ class Surface
    */
    bool surface_difference(Surface other)
    {    
+     ScopedTimer timer("Surface::surface_difference");
      assert_non_empty_mesh();
      other.assert_non_empty_mesh();
      try 
@@ -1356,6 +1384,7 @@ class Surface
    */
    bool surface_union(Surface other)
    {  
+     ScopedTimer timer("Surface::surface_union");
      assert_non_empty_mesh();
      other.assert_non_empty_mesh();
      try 
@@ -1396,9 +1425,11 @@ class Surface
                vertices(mesh).end(),
                Splitter(),
                Traits(vppmap));
+     counters.increment(QueryCounters::KD_TREE_CONSTRUCTIONS);
 
      Distance tr_dist(vppmap);
      K_neighbor_search search(tree, p1, num, 0, true, tr_dist); 
+     counters.increment(QueryCounters::NEAREST_NEIGHBOUR_SEARCHES);
  
      for(auto vit=search.begin(); vit!=search.end(); ++vit) 
         results.push_back(vit->first); 
@@ -1522,6 +1553,7 @@ class Surface
    */
    std::shared_ptr<Surface> cylindrical_connection(Surface other, double radius, double edge_length)
    {
+      ScopedTimer timer("Surface::cylindrical_connection");
       assert_non_empty_mesh();
       vertex_vector results;
       Vertex_point_pmap vppmap = get(CGAL::vertex_point,other.get_mesh());  
@@ -1531,6 +1563,7 @@ class Surface
                 Splitter(),
                Traits(vppmap)
       );
+      counters.increment(QueryCounters::KD_TREE_CONSTRUCTIONS);
       Distance tr_dist(vppmap);
       FT distance;
       FT min_distance = FT(std::numeric_limits<double>::max());
@@ -1540,6 +1573,7 @@ class Surface
       for(vertex_descriptor vit : mesh.vertices())
       {
          K_neighbor_search search(tree, mesh.point(vit), 2,0,true,tr_dist); 
+         counters.increment(QueryCounters::NEAREST_NEIGHBOUR_SEARCHES);
         
          query_point = other.get_mesh().point((search.begin())->first);
 
@@ -1718,6 +1752,7 @@ class Surface
    */
    void smooth_taubin(const size_t nb_iter) 
    {
+       ScopedTimer timer("Surface::smooth_taubin");
        for(size_t i = 0; i < nb_iter; ++i) 
        {
            this->smooth_laplacian(0.8,1);  
@@ -1773,6 +1808,7 @@ class Surface
    */
    int collapse_edges(const double target_edge_length)
    {
+      ScopedTimer timer("Surface::collapse_edges");
       assert_non_empty_mesh();
       CGAL::Surface_mesh_simplification::Edge_length_stop_predicate<double> stop(target_edge_length);
 
@@ -1900,6 +1936,7 @@ class Surface
    */
    void isotropic_remeshing(double target_edge_length, unsigned int nb_iter, bool protect_border)
    {
+       ScopedTimer timer("Surface::isotropic_remeshing");
        assert_non_empty_mesh();
        
        if( protect_border )
@@ -2084,6 +2121,7 @@ class Surface
    */
    int fill_holes()
    {
+     ScopedTimer timer("Surface::fill_holes");
      unsigned int nb_holes = 0;
      std::vector<halfedge_descriptor> border_cycles;
      
@@ -2162,7 +2200,9 @@ class Surface
    {
       assert_non_empty_mesh();
       Inside is_inside_query(mesh);
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS);
       CGAL::Bounded_side res = is_inside_query(point_3);
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_QUERIES);
       if (res == CGAL::ON_BOUNDED_SIDE or res == CGAL::ON_BOUNDARY)
          return true;
       else 
@@ -2172,7 +2212,9 @@ class Surface
    {
       assert_non_empty_mesh();
       Inside is_inside_query(mesh);
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_CONSTRUCTIONS);
       CGAL::Bounded_side res = is_inside_query(point_3);
+      counters.increment(QueryCounters::SIDE_OF_TRIANGLE_MESH_QUERIES);
       if ( res==CGAL::ON_BOUNDARY )
          return true;
       else 
@@ -2209,6 +2251,7 @@ class Surface
    */
    void smooth_laplacian(const double c, int nb_iter)
    {
+      ScopedTimer timer("Surface::smooth_laplacian");
       assert_non_empty_mesh();
       Mesh::Vertex_range::iterator  vb = mesh.vertices().begin(), ve=mesh.vertices().end();
       for(int i=0; i<nb_iter; ++i)
@@ -2227,6 +2270,7 @@ class Surface
    */
    void smooth_shape(double time,int nb_iter)
    {
+      ScopedTimer timer("Surface::smooth_shape");
       assert_non_empty_mesh();
       CGAL::Polygon_mesh_processing::smooth_shape(mesh, time, CGAL::Polygon_mesh_processing::parameters::number_of_iterations(nb_iter));
    }
@@ -2299,6 +2343,7 @@ class Surface
       std::vector<Point_3> points;
 
       AABB_Tree tree(faces(mesh).first, faces(mesh).second, mesh); 
+      counters.increment(QueryCounters::AABB_TREE_CONSTRUCTIONS);
       Surface_mesh_shortest_path shortest_paths(mesh);     
 
       Face_location source_location = shortest_paths.locate(source,tree);
@@ -2665,16 +2710,16 @@ class Surface
 
   /**
    * \struct 
-   * @brief Implicit function for a sphere with static center and radius.
+   * @brief Implicit function for a sphere with center and radius.
    * 
    */
   struct sphere_wrapper{      
      public:
-        static double radius;
-        static double x0;
-        static double y0;
-        static double z0;
-        static double function(double x, double y, double z){return  (x-x0)*(x -x0) +  (y-y0)*(y -y0) + (z-z0)*(z -z0) -radius*radius;}
+        double radius;
+        double x0;
+        double y0;
+        double z0;
+        double operator()(double x, double y, double z) const {return  (x-x0)*(x -x0) +  (y-y0)*(y -y0) + (z-z0)*(z -z0) -radius*radius;}
         
    };
    
@@ -2694,6 +2739,7 @@ class Surface
    */
    void make_sphere( double x0, double y0, double  z0,double r0, double edge_length) 
    {    
+      ScopedTimer timer("Surface::make_sphere");
       if( 2*CGAL_PI*r0<3*edge_length ) 
          throw InvalidArgumentError("Select smaller edge length."); 
   
@@ -2702,7 +2748,7 @@ class Surface
       sphere.x0=x0;
       sphere.y0=y0;
       sphere.z0=z0;
-      surface_mesher(mesh,sphere.function,x0,y0,z0,r0,30,edge_length,edge_length);   
+      surface_mesher(mesh,sphere,x0,y0,z0,r0,30,edge_length,edge_length);   
    }
 
   // DocString: make_sphere   
@@ -2811,6 +2857,7 @@ class Surface
    */
    void save(const std::string outpath)
    {    
+      ScopedTimer timer("Surface::save");
       assert_non_empty_mesh();    
       std::string extension = outpath.substr(outpath.find_last_of(".")+1);
       std::ofstream out(outpath);
@@ -2912,7 +2959,7 @@ class Surface
              this->repair_self_intersections(); 
              vertices = get_vertices_with_property<A,B>(other);
           }
-          if( ++iter>max_iter and after>0 )
+          if( ( ++iter>max_iter or cancellation_requested() ) and after>0 )
              return std::make_pair(false, after);
              
           if( after>before ) 
@@ -2953,7 +3000,7 @@ class Surface
           smooth_laplacian_region(vertices.begin(), vertices.end(), smoothing);      
           get_close_vertices<A>(other, vertices);
           after = vertices.size();  
-          if( ++iter>max_iter and after>0 )
+          if( ( ++iter>max_iter or cancellation_requested() ) and after>0 )
              return std::make_pair(false, after);
           if( after>before ) 
              throw AlgorithmError("The aglorithm failed, select a smaller adjustment parameter"); 
@@ -2989,7 +3036,7 @@ class Surface
           smooth_laplacian_region(vertices.begin(),vertices.end(), smoothing);   // add smoothing?   
           get_close_vertices_with_direction<A>(other,vertices,adjustment);
           after = vertices.size();         
-          if( ++iter>max_iter and after>0 )
+          if( ( ++iter>max_iter or cancellation_requested() ) and after>0 )
             return std::make_pair(false, after);
           if( after>before ) 
             throw AlgorithmError("The aglorithm failed, select a smaller adjustment parameter"); 
@@ -3032,6 +3079,7 @@ class Surface
     AABB_Tree get_AABB_tree()
     {
        AABB_Tree tree(faces(mesh).first, faces(mesh).second, mesh);
+       counters.increment(QueryCounters::AABB_TREE_CONSTRUCTIONS);
     
        return tree;
     
@@ -3103,20 +3151,31 @@ class Surface
     
     
           
+    // DocString: get_counters
+   /**
+    * @brief Returns the number of inside queries, AABB and kd-tree constructions and 
+    *        nearest neighbour searches performed by this SVMTK Surface object.
+    * @returns a map with counter names as keys and counts as values.
+    */
+    std::map<std::string,std::size_t> get_counters()
+    {
+       return counters.get_counters();
+    }
+
+    // DocString: reset_counters
+   /**
+    * @brief Sets all query counters to zero.
+    */
+    void reset_counters()
+    {
+       counters.reset();
+    }
+          
    protected:
     Mesh mesh;
+    QueryCounters counters;
 };
 
-/**
- * @brief Inline declaration of static variables in header files requrie c++ version equal or greate than 7 
- *       with the compiler option c++1z/c++17.
- * @hideinitializer 
-*/
-inline double Surface::sphere_wrapper::radius = 0; // inline declaration of static variable radius for sphere wrapper.
-inline double Surface::sphere_wrapper::x0 = 0;     // inline declaration of static variable radius for sphere wrapper.
-inline double Surface::sphere_wrapper::y0 = 0;     // inline declaration of static variable radius for sphere wrapper.
-inline double Surface::sphere_wrapper::z0 = 0;     // inline declaration of static variable radius for sphere wrapper.
-
 /** 
  * @brief Constructs a convex hull from a vector of points
  *
@@ -3153,6 +3212,7 @@ std::shared_ptr<Surface> convex_hull(std::vector<Point_3 >& point_vector)
 template<typename Surface>
 bool separate_surface_overlapp(Surface& surf1, Surface& surf2, double edge_movement=-0.25, double smoothing=0.3, int max_iter=400)
 {
+  ScopedTimer timer("separate_surface_overlapp");
   typedef typename Surface::vertex_vector vertex_vector;
   typedef typename Surface::vertex_descriptor vertex_descriptor;
   
@@ -3206,6 +3266,8 @@ bool separate_surface_overlapp(Surface& surf1, Surface& surf2, double edge_movem
           std::cout << "Recommended to use istropic_remeshing before continuation"  << std::endl; 
           return false;
        }
+       if( cancellation_requested() )
+         return false;
        if( iter++>max_iter )
        {
          std::cout << "Failed to converge in "<< max_iter <<" steps, terminating" << std::endl;
@@ -3238,6 +3300,7 @@ bool separate_surface_overlapp(Surface& surf1, Surface& surf2, double edge_movem
 template<typename Surface>
 bool separate_surface_overlapp(Surface& surf1, Surface& surf2, Surface& other, double edge_movement=-0.25, double smoothing=0.3, int max_iter=400)
 {
+   ScopedTimer timer("separate_surface_overlapp");
    typedef typename Surface::vertex_vector vertex_vector;
    typedef typename Surface::vertex_descriptor vertex_descriptor;
 
@@ -3296,6 +3359,8 @@ bool separate_surface_overlapp(Surface& surf1, Surface& surf2, Surface& other, d
            std::cout << "Recommend use istropic_remeshing before continuation"  << std::endl;
            return false;
         }
+        if( cancellation_requested() )
+          return false;
         if( iter++>max_iter)
         {
            std::cout << "Failed to converge in "<< max_iter <<" steps, terminating" << std::endl;
@@ -3331,6 +3396,7 @@ bool separate_surface_overlapp(Surface& surf1, Surface& surf2, Surface& other, d
 template< typename Surface>
 bool separate_close_surfaces(Surface& surf1, Surface& surf2, Surface& other, double edge_movement=-0.25, double smoothing=0.3, int max_iter=400)
 {
+   ScopedTimer timer("separate_close_surfaces");
    typedef typename Surface::vertex_vector_map vertex_vector_map;
 
    double s1ael = surf1.average_edge_length();
@@ -3382,6 +3448,8 @@ bool separate_close_surfaces(Surface& surf1, Surface& surf2, Surface& other, dou
            std::cout << "Recommend use istropic_remeshing before continuation"  << std::endl;
            return false;
         }
+        if( cancellation_requested() )
+          return false;
         if( iter++>max_iter)
         {
            std::cout << "Failed to converge in "<< max_iter <<" steps, terminating" << std::endl;
@@ -3413,6 +3481,7 @@ bool separate_close_surfaces(Surface& surf1, Surface& surf2, Surface& other, dou
 template<typename Surface> 
 bool separate_close_surfaces(Surface& surf1, Surface& surf2, double edge_movement=-0.5, double smoothing=0.25, int max_iter=400)
 {
+   ScopedTimer timer("separate_close_surfaces");
    typedef typename Surface::vertex_vector_map vertex_vector_map;
      
    double s1ael = surf1.average_edge_length();
@@ -3461,6 +3530,8 @@ bool separate_close_surfaces(Surface& surf1, Surface& surf2, double edge_movemen
         }
 
 
+        if( cancellation_requested() )
+          return false;
         if( iter++>max_iter )
         {
            std::cout << "Failed to converge in "<< max_iter <<" steps, terminating" << std::endl;
@@ -3495,6 +3566,7 @@ bool separate_close_surfaces(Surface& surf1, Surface& surf2, double edge_movemen
 template<typename Surface> 
 std::shared_ptr<Surface> union_partially_overlapping_surfaces( Surface& surf1, Surface& surf2, double angle_in_degree, double adjustment, double smoothing, int max_iter )
 {
+     ScopedTimer timer("union_partially_overlapping_surfaces");
      typedef typename Surface::vertex_vector vertex_vector;
      typedef typename Surface::vertex_descriptor vertex_descriptor;
  
@@ -3525,7 +3597,7 @@ std::shared_ptr<Surface> union_partially_overlapping_surfaces( Surface& surf1, S
               
            s1vertices  = surf1.get_vertices_outside(surf2,s1vertices); 
            s2vertices  = surf2.get_vertices_outside(surf1,s2vertices);
-           if( iter++>max_iter )
+           if( iter++>max_iter or cancellation_requested() )
               break;
      }     
      surf1.repair_self_intersections();
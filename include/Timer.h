@@ -0,0 +1,207 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Timer_H
+
+#define Timer_H
+/* --- Includes -- */
+
+#include <atomic>                                   // for atomic
+#include <chrono>                                   // for steady_clock
+#include <fstream>                                  // for ofstream
+#include <functional>                               // for hash
+#include <iomanip>                                  // for setprecision
+#include <map>                                      // for map
+#include <mutex>                                    // for mutex, lock_guard
+#include <string>                                   // for string
+#include <thread>                                   // for this_thread
+#include <vector>                                   // for vector
+#include "Errors.h"                                 // for InvalidArgumentError
+
+/**
+ * \class PhaseTimings
+ *
+ * Global registry of timed phases in SVMTK, e.g. Mesh_3 refinement,
+ * optimization and file output. Each phase is recorded as an event with
+ * start time and duration, so that the timings can be summed per phase or
+ * exported as a Chrome trace (chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Recording is disabled by default, and a disabled registry only costs
+ * a relaxed atomic load per timed scope.
+ */
+class PhaseTimings
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * \struct Event
+     * A completed phase, with time in microseconds relative to the registry epoch.
+     */
+    struct Event
+    {
+      std::string name;
+      double start;
+      double duration;
+      std::size_t thread;
+    };
+
+    /**
+     * @brief Returns the global registry.
+     * @returns the global registry.
+     */
+    static PhaseTimings& instance()
+    {
+       static PhaseTimings timings;
+       return timings;
+    }
+
+    /**
+     * @brief Enables or disables recording of phases.
+     * @param enable true to enable recording.
+     */
+    void enable(bool enable=true)
+    {
+       enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns true if recording is enabled.
+     * @returns true if recording is enabled.
+     */
+    bool is_enabled() const
+    {
+       return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Removes all recorded events.
+     */
+    void clear()
+    {
+       std::lock_guard<std::mutex> lock(mutex);
+       events.clear();
+    }
+
+    /**
+     * @brief Records a completed phase.
+     * @param name of the phase.
+     * @param begin start time of the phase.
+     * @param end end time of the phase.
+     */
+    void add(const char* name, Clock::time_point begin, Clock::time_point end)
+    {
+       Event event;
+       event.name = name;
+       event.start = std::chrono::duration<double,std::micro>(begin-epoch).count();
+       event.duration = std::chrono::duration<double,std::micro>(end-begin).count();
+       event.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+       std::lock_guard<std::mutex> lock(mutex);
+       events.push_back(event);
+    }
+
+    /**
+     * @brief Returns a copy of all recorded events.
+     * @returns a copy of all recorded events.
+     */
+    std::vector<Event> get_events()
+    {
+       std::lock_guard<std::mutex> lock(mutex);
+       return events;
+    }
+
+    /**
+     * @brief Returns the accumulated time in seconds of each recorded phase.
+     * @returns a map with phase names as keys and seconds as values.
+     */
+    std::map<std::string,double> get_timings()
+    {
+       std::map<std::string,double> result;
+       std::lock_guard<std::mutex> lock(mutex);
+       for(auto const& event : events)
+          result[event.name] += event.duration*1.e-6;
+       return result;
+    }
+
+    /**
+     * @brief Writes the recorded events to file in the Chrome trace event format.
+     * @param filename path to the output json file.
+     * @throws InvalidArgumentError if the file can not be opened.
+     */
+    void write_chrome_trace(std::string filename)
+    {
+       std::ofstream out(filename);
+       if( !out.is_open() )
+         throw InvalidArgumentError("Can't open file.");
+       out << std::setprecision(17);
+       out << "{\"traceEvents\":[";
+       std::lock_guard<std::mutex> lock(mutex);
+       for(std::size_t i = 0; i < events.size(); ++i)
+       {
+          if( i>0 )
+            out << ",";
+          out << "\n{\"name\":\"" << events[i].name << "\",\"cat\":\"SVMTK\",\"ph\":\"X\""
+              << ",\"ts\":"  << events[i].start
+              << ",\"dur\":" << events[i].duration
+              << ",\"pid\":0,\"tid\":" << events[i].thread % 1000000 << "}";
+       }
+       out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+  private:
+    PhaseTimings() : epoch(Clock::now()) {}
+    PhaseTimings(const PhaseTimings&) = delete;
+    PhaseTimings& operator=(const PhaseTimings&) = delete;
+
+    std::atomic<bool> enabled{false};
+    Clock::time_point epoch;
+    std::mutex mutex;
+    std::vector<Event> events;
+};
+
+/**
+ * \class ScopedTimer
+ *
+ * Records the lifetime of the object as a phase in PhaseTimings.
+ * Does nothing if PhaseTimings is disabled when the object is constructed.
+ *
+ * @note The name is not copied, and should be a string literal.
+ */
+class ScopedTimer
+{
+  public:
+    explicit ScopedTimer(const char* name) : name(name), active(PhaseTimings::instance().is_enabled())
+    {
+       if( active )
+         begin = PhaseTimings::Clock::now();
+    }
+
+    ~ScopedTimer()
+    {
+       if( active )
+         PhaseTimings::instance().add(name, begin, PhaseTimings::Clock::now());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    const char* name;
+    bool active;
+    PhaseTimings::Clock::time_point begin;
+};
+
+#endif
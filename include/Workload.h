@@ -0,0 +1,341 @@
+// Copyright (C) 2018-2021 Lars Magnus Valnes
+//
+// This file is part of Surface Volume Meshing Toolkit (SVM-TK).
+//
+// SVM-Tk is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SVM-Tk is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SVM-Tk.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef Workload_H
+
+#define Workload_H
+/* --- Includes -- */
+#include "SubdomainMap.h"
+#include "Errors.h"
+
+/* -- STL -- */
+#include <algorithm>                                // for sort, max
+#include <array>                                    // for array
+#include <cmath>                                    // for sqrt, acos
+#include <memory>                                   // for shared_ptr
+#include <random>                                   // for mt19937
+#include <string>                                   // for string
+#include <vector>                                   // for vector
+
+/**
+ * \struct Workload
+ * A synthetic multi-surface scene for benchmarks and stress tests of the meshing,
+ * i.e. the surfaces and a matching SubdomainMap, @see make_workload.
+ *
+ * @tparam Surface SVMTK Surface class.
+ */
+template<typename Surface>
+struct Workload
+{
+    std::string name;
+    std::vector<Surface> surfaces;
+    std::shared_ptr<SubdomainMap> map;
+    double edge_length = 0;
+
+    /**
+     * @brief Returns the total number of triangles of the surfaces.
+     * @returns the number of triangles.
+     */
+    int number_of_triangles() const
+    {
+       int result = 0;
+       for(auto const& surface : surfaces)
+          result += surface.num_faces();
+       return result;
+    }
+};
+
+/**
+ * @brief Returns the edge length that gives approximately a number of equilateral triangles on a surface area.
+ * @param area the total surface area.
+ * @param number_of_triangles the target number of triangles.
+ * @returns the edge length.
+ */
+inline double workload_edge_length(double area, int number_of_triangles)
+{
+   return std::sqrt(4.*area/(std::sqrt(3.)*number_of_triangles));
+}
+
+/**
+ * @brief Returns the bitstring of a SubdomainMap with ones for the given surfaces.
+ * @param number_of_surfaces the length of the bitstring.
+ * @param inside the surfaces that contain the subdomain.
+ * @returns the bitstring.
+ */
+inline std::string workload_bitstring(int number_of_surfaces, const std::vector<int>& inside)
+{
+   std::string bits(number_of_surfaces, '0');
+   for(int i : inside)
+      bits[i] = '1';
+   return bits;
+}
+
+/**
+ * @brief Returns the smallest number of cells in each direction of a cubic grid with at least n cells.
+ * @param n the number of cells.
+ * @returns the number of cells in each direction.
+ */
+inline int workload_grid_side(int n)
+{
+   int side = 1;
+   while( side*side*side < n )
+      ++side;
+   return side;
+}
+
+/**
+ * @brief Returns the position of a cell in a cubic grid.
+ * @param i the index of the cell.
+ * @param side the number of cells in each direction.
+ * @returns the integer coordinates of the cell.
+ */
+inline std::array<int,3> workload_grid_position(int i, int side)
+{
+   return {i%side, (i/side)%side, i/(side*side)};
+}
+
+/**
+ * @brief Creates nested spherical shells, where surface i is a sphere with radius i+1.
+ *
+ * The subdomain between sphere i-1 and sphere i has tag i+1.
+ * @param number_of_surfaces the number of spheres.
+ * @param number_of_triangles the target total number of triangles.
+ * @returns the workload.
+ */
+template<typename Surface>
+Workload<Surface> nested_shells(int number_of_surfaces, int number_of_triangles)
+{
+   Workload<Surface> workload;
+   workload.name = "nested_shells";
+   workload.map = std::make_shared<SubdomainMap>(number_of_surfaces);
+   const double pi = std::acos(-1.);
+   double area = 0;
+   for(int i = 0; i < number_of_surfaces; ++i)
+      area += 4.*pi*(i+1)*(i+1);
+   workload.edge_length = workload_edge_length(area, number_of_triangles);
+   for(int i = 0; i < number_of_surfaces; ++i)
+   {
+      Surface surface;
+      surface.make_sphere(0., 0., 0., i+1., workload.edge_length);
+      workload.surfaces.push_back(surface);
+      std::vector<int> inside;
+      for(int j = i; j < number_of_surfaces; ++j)
+         inside.push_back(j);
+      workload.map->add(workload_bitstring(number_of_surfaces, inside), i+1);
+   }
+   return workload;
+}
+
+/**
+ * @brief Creates non-overlapping spheres with random radii, placed at jittered positions in a cubic grid.
+ *
+ * The subdomain inside sphere i has tag i+1. The gap between two spheres is at least 0.1.
+ * @param number_of_surfaces the number of spheres.
+ * @param number_of_triangles the target total number of triangles.
+ * @param seed the seed of the random radii and positions.
+ * @returns the workload.
+ */
+template<typename Surface>
+Workload<Surface> packed_spheres(int number_of_surfaces, int number_of_triangles, unsigned int seed=0)
+{
+   Workload<Surface> workload;
+   workload.name = "packed_spheres";
+   workload.map = std::make_shared<SubdomainMap>(number_of_surfaces);
+   int side = workload_grid_side(number_of_surfaces);
+   std::mt19937 generator(seed);
+   std::uniform_real_distribution<double> uniform(0., 1.);
+   std::vector<std::array<double,4>> spheres;
+   const double pi = std::acos(-1.);
+   double area = 0;
+   for(int i = 0; i < number_of_surfaces; ++i)
+   {
+      double r = 0.25 + 0.15*uniform(generator);
+      double jitter = 0.45 - r;
+      auto cell = workload_grid_position(i, side);
+      std::array<double,4> sphere;
+      for(int k = 0; k < 3; ++k)
+         sphere[k] = cell[k] + jitter*(2*uniform(generator) - 1);
+      sphere[3] = r;
+      spheres.push_back(sphere);
+      area += 4.*pi*r*r;
+   }
+   workload.edge_length = workload_edge_length(area, number_of_triangles);
+   for(int i = 0; i < number_of_surfaces; ++i)
+   {
+      Surface surface;
+      surface.make_sphere(spheres[i][0], spheres[i][1], spheres[i][2], spheres[i][3], workload.edge_length);
+      workload.surfaces.push_back(surface);
+      workload.map->add(workload_bitstring(number_of_surfaces, {i}), i+1);
+   }
+   return workload;
+}
+
+/**
+ * @brief Creates unit cubes in a cubic grid, where neighbouring cubes share a face.
+ *
+ * The subdomain inside cube i has tag i+1.
+ * @param number_of_surfaces the number of cubes.
+ * @param number_of_triangles the target total number of triangles.
+ * @returns the workload.
+ */
+template<typename Surface>
+Workload<Surface> touching_blocks(int number_of_surfaces, int number_of_triangles)
+{
+   Workload<Surface> workload;
+   workload.name = "touching_blocks";
+   workload.map = std::make_shared<SubdomainMap>(number_of_surfaces);
+   int side = workload_grid_side(number_of_surfaces);
+   workload.edge_length = workload_edge_length(6.*number_of_surfaces, number_of_triangles);
+   for(int i = 0; i < number_of_surfaces; ++i)
+   {
+      auto cell = workload_grid_position(i, side);
+      Surface surface;
+      surface.make_cube(cell[0], cell[1], cell[2], cell[0]+1., cell[1]+1., cell[2]+1., workload.edge_length);
+      workload.surfaces.push_back(surface);
+      workload.map->add(workload_bitstring(number_of_surfaces, {i}), i+1);
+   }
+   return workload;
+}
+
+/**
+ * @brief Creates a network of overlapping tubes along the edges of a cubic lattice, inside a box.
+ *
+ * Surface 0 is the box, and the other surfaces are cylinders with radius 0.15 between neighbouring
+ * lattice nodes, extended past the nodes so that the tubes overlap at the junctions. The tubes are
+ * taken in order of distance from the origin, so that the network is connected. The subdomain inside
+ * the box has tag 1, and the subdomain inside one or more tubes has tag 2.
+ * @param number_of_surfaces the number of surfaces, i.e. the box and at least one tube.
+ * @param number_of_triangles the target total number of triangles.
+ * @returns the workload.
+ */
+template<typename Surface>
+Workload<Surface> tubular_network(int number_of_surfaces, int number_of_triangles)
+{
+   if( number_of_surfaces<2 )
+     throw InvalidArgumentError("A tubular network requires at least two surfaces.");
+   Workload<Surface> workload;
+   workload.name = "tubular_network";
+   workload.map = std::make_shared<SubdomainMap>(number_of_surfaces);
+   const int tubes = number_of_surfaces-1;
+   const double radius = 0.15;
+
+   int side = 2;
+   while( 3*side*side*(side-1) < tubes )
+      ++side;
+   typedef std::array<int,3> Node;
+   std::vector<std::pair<Node,Node>> edges;
+   for(int i = 0; i < side*side*side; ++i)
+   {
+      Node node = workload_grid_position(i, side);
+      for(int k = 0; k < 3; ++k)
+      {
+         Node next = node;
+         next[k] += 1;
+         if( next[k]<side )
+           edges.push_back(std::make_pair(node, next));
+      }
+   }
+   auto distance = [](const std::pair<Node,Node>& edge)
+   {
+      int result = 0;
+      for(int k = 0; k < 3; ++k)
+         result += edge.first[k] + edge.second[k];
+      return result;
+   };
+   std::stable_sort(edges.begin(), edges.end(), [&](const std::pair<Node,Node>& a, const std::pair<Node,Node>& b) { return distance(a)<distance(b); });
+   edges.resize(tubes);
+
+   Node extent{0, 0, 0};
+   for(auto const& edge : edges)
+      for(int k = 0; k < 3; ++k)
+         extent[k] = std::max(extent[k], edge.second[k]);
+   const double margin = 0.5;
+   const double pi = std::acos(-1.);
+   double area = 0;
+   for(int k = 0; k < 3; ++k)
+      area += 2.*(extent[(k+1)%3] + 2*margin)*(extent[(k+2)%3] + 2*margin);
+   area += tubes*(2.*pi*radius*(1. + 2*radius) + 2.*pi*radius*radius);
+   workload.edge_length = workload_edge_length(area, number_of_triangles);
+
+   Surface box;
+   box.make_cube(-margin, -margin, -margin, extent[0]+margin, extent[1]+margin, extent[2]+margin, workload.edge_length);
+   workload.surfaces.push_back(box);
+   std::vector<std::vector<int>> junctions(side*side*side);
+   for(int i = 0; i < tubes; ++i)
+   {
+      const Node& a = edges[i].first;
+      const Node& b = edges[i].second;
+      double p0[3], p1[3];
+      for(int k = 0; k < 3; ++k)
+      {
+         double direction = b[k] - a[k];
+         p0[k] = a[k] - radius*direction;
+         p1[k] = b[k] + radius*direction;
+      }
+      Surface tube;
+      tube.make_cylinder(p0[0], p0[1], p0[2], p1[0], p1[1], p1[2], radius, workload.edge_length);
+      workload.surfaces.push_back(tube);
+      junctions[a[0] + side*(a[1] + side*a[2])].push_back(i+1);
+      junctions[b[0] + side*(b[1] + side*b[2])].push_back(i+1);
+   }
+
+   workload.map->add(workload_bitstring(number_of_surfaces, {0}), 1);
+   for(int i = 1; i < number_of_surfaces; ++i)
+      workload.map->add(workload_bitstring(number_of_surfaces, {0, i}), 2);
+   // Overlaps at the junctions, i.e. every subset of the tubes that meet at a lattice node.
+   for(auto const& junction : junctions)
+      for(unsigned int subset = 1; subset < (1u << junction.size()); ++subset)
+      {
+         std::vector<int> inside{0};
+         for(std::size_t j = 0; j < junction.size(); ++j)
+            if( subset & (1u << j) )
+              inside.push_back(junction[j]);
+         if( inside.size()>2 )
+           workload.map->add(workload_bitstring(number_of_surfaces, inside), 2);
+      }
+   return workload;
+}
+
+/**
+ * @brief Creates a synthetic scene for benchmarks and stress tests of the meshing.
+ *
+ * The surfaces are generated with the Surface primitives, with an edge length chosen so that
+ * the total number of triangles is approximately number_of_triangles, and the workload is
+ * reproducible for a given seed.
+ * @param scene "nested_shells", "packed_spheres", "touching_blocks" or "tubular_network".
+ * @param number_of_surfaces the number of surfaces.
+ * @param number_of_triangles the target total number of triangles.
+ * @param seed the seed of the random scenes.
+ * @returns the workload.
+ * @throws InvalidArgumentError if the scene is unknown, or the numbers are not positive.
+ */
+template<typename Surface>
+Workload<Surface> make_workload(std::string scene, int number_of_surfaces, int number_of_triangles, unsigned int seed=0)
+{
+   if( number_of_surfaces<1 or number_of_triangles<1 )
+     throw InvalidArgumentError("The number of surfaces and triangles must be positive.");
+   if( scene=="nested_shells" )
+     return nested_shells<Surface>(number_of_surfaces, number_of_triangles);
+   if( scene=="packed_spheres" )
+     return packed_spheres<Surface>(number_of_surfaces, number_of_triangles, seed);
+   if( scene=="touching_blocks" )
+     return touching_blocks<Surface>(number_of_surfaces, number_of_triangles);
+   if( scene=="tubular_network" )
+     return tubular_network<Surface>(number_of_surfaces, number_of_triangles);
+   throw InvalidArgumentError(("Unknown workload scene: " + scene).c_str());
+}
+
+#endif
@@ -23,6 +23,94 @@
 #endif
 
 
+static const char *__doc_BatchMesher =
+R"doc(Meshes many independent domains concurrently, one job per worker thread.
+
+The jobs are started in order of decreasing memory estimate. A job is only admitted when the sum of the memory estimates of the running jobs stays below the memory limit, or when no other job is running. The memory estimate of a job is the number of input faces times the largest number of bytes per input face observed in the completed jobs, unless the job sets memory_estimate.
+
+)doc";
+
+static const char *__doc_BatchMesher_BatchMesher =
+R"doc(Constructs a batch mesher.
+
+:param num_threads: Number of worker threads, a non-positive value uses the number of hardware threads.
+:param memory_limit: The admission limit in bytes for the running jobs, zero means no limit.
+
+)doc";
+
+static const char *__doc_BatchMesher_get_bytes_per_face =
+R"doc(Returns the number of bytes per input face used to estimate the memory of a job.
+
+:Returns: The number of bytes per input face.
+
+)doc";
+
+static const char *__doc_BatchMesher_run =
+R"doc(Runs all jobs, and returns when every job is completed, failed or cancelled.
+
+An exception raised by a job is stored in the error of its result, and does not stop the other jobs. The jobs share the active :class:`CancellationToken`.
+
+:param jobs: List of :class:`MeshingJob` objects.
+
+:Returns: List of :class:`MeshingResult` objects in the same order as the jobs.
+
+)doc";
+
+static const char *__doc_CancellationToken =
+R"doc(Cooperative cancellation and wall-clock budget for long running operations.
+
+The long running operations, i.e. :func:`Domain.create_mesh`, the mesh optimizers, :func:`Surface.embed`, :func:`Surface.enclose`, :func:`Surface.expose`, :func:`Surface.separate` and the surface separation functions, check the active token at safe points. If the token is cancelled or the time budget has expired, the operation stops and returns a partial-progress status. The token is activated with a with-statement:
+
+    with SVMTK.CancellationToken(60.0):
+        completed = domain.create_mesh(32.)
+
+A KeyboardInterrupt during an operation cancels the active token, and is raised when the operation returns.
+
+)doc";
+
+static const char *__doc_CancellationToken_CancellationToken =
+R"doc(Constructs a token without time budget.
+
+)doc";
+
+static const char *__doc_CancellationToken_CancellationToken_2 =
+R"doc(Constructs a token with a wall-clock budget, measured from construction.
+
+:param time_budget: Time budget in seconds.
+
+)doc";
+
+static const char *__doc_CancellationToken_cancel =
+R"doc(Requests cancellation of the operations that use this token.
+
+)doc";
+
+static const char *__doc_CancellationToken_is_cancelled =
+R"doc(Checks if cancellation is requested or the time budget has expired.
+
+:Returns: True if cancelled.
+
+)doc";
+
+static const char *__doc_CancellationToken_remaining_time =
+R"doc(Returns the remaining time of the budget.
+
+:Returns: Remaining time in seconds, or infinity if no time budget is set.
+
+)doc";
+
+static const char *__doc_CancellationToken_reset =
+R"doc(Removes the cancellation request and the time budget.
+
+)doc";
+
+static const char *__doc_CancellationToken_set_time_budget =
+R"doc(Sets a wall-clock budget measured from now.
+
+:param seconds: Time budget in seconds, a non-positive value removes the budget.
+
+)doc";
+
 static const char *__doc_DefaultMap =
 R"doc(The defualt method to set subdomains in the mesh. Uses
 bitstring to integer conversion to set subdomain tag.)doc";
@@ -76,6 +164,7 @@ R"doc(Constructor for meshing a single surface
 
 :param surface: :class:`Surface` object.
 :param error_bound: the error bound of the surface representation.
+:param validate: option to check the surface for self-intersections before meshing, see :func:`check_surfaces`.
 
 )doc";
 
@@ -84,6 +173,7 @@ R"doc(Constructor for meshing multiple surfaces
 
 :param surfaces: List of :class:`Surface` objects.
 :param error_bound: the error bound of the surface representation.
+:param validate: option to check the surfaces for intersections before meshing, see :func:`check_surfaces`.
 
 )doc";
 
@@ -93,6 +183,7 @@ R"doc(Constructor for meshing multiple surfaces
 :param surfaces: List of :class:`Surface` objects.
 :param map: :class:`SubDomainMap` object, used to set subdomain and boundary tags.
 :param error_bound: the error bound of the surface representation.
+:param validate: option to check the surfaces for intersections and the nesting of the map before meshing, see :func:`check_surfaces`.
 
 )doc";
 
@@ -110,10 +201,156 @@ R"doc(Adds a polyline to the Domain attribute features.
 
 )doc";
 
+static const char *__doc_Domain_add_intersection_features =
+R"doc(Adds the intersection curves of the input surfaces to the features of the Domain, so that the curves are protected instead of resolved by refinement.
+
+The intersection polylines of each pair of surfaces with overlapping bounding boxes are computed concurrently. Polylines of surface pairs with a common surface are split where they cross, so that the junctions become corners of the 1D features.
+
+:param num_threads: the number of threads, non-positive uses the number of hardware threads.
+:returns: the number of added polylines.
+
+)doc";
+
+static const char *__doc_Domain_check_surfaces =
+R"doc(Checks the input surfaces for clashes that make the meshing fail or run for a long time.
+
+Candidate triangle pairs are found with box intersection and tested for intersection concurrently. For a SubdomainMap, a surface is implied to be nested inside another surface if every tagged region inside the first surface is also inside the second, and the nesting is checked for surfaces that do not intersect.
+
+:param num_threads: the number of threads, non-positive uses the number of hardware threads.
+:returns: list of SurfaceClash objects, i.e. one for each self-intersecting surface, each pair of intersecting surfaces and each violated nesting.
+
+)doc";
+
 static const char *__doc_Domain_clear_borders = R"doc(Clear borders.)doc";
 
 static const char *__doc_Domain_clear_features = R"doc(Clear features.)doc";
 
+static const char *__doc_Domain_clear_region_of_interest =
+R"doc(Removes the region of interest, so that the whole bounding box of the surfaces is meshed.
+
+)doc";
+
+static const char *__doc_Domain_create_mesh_clusters =
+R"doc(Creates the mesh stored in the class member variable c3t3, where
+spatially separated clusters of surfaces, e.g. separate organs, are
+meshed concurrently.
+
+Surfaces and 1D features are in the same cluster if their bounding
+boxes are closer than twice the cell size. Each cluster is meshed in
+its own complex against the labeling of all the surfaces restricted to
+the cluster, so the tags are the same as with create_mesh(const
+double). The complexes are merged into one mesh with renumbered
+vertices. If the clusters are too close to be merged, the mesh is
+created with create_mesh(const double).
+
+Parameter ``mesh_resolution``:
+    the mesh resolution, @see create_mesh(const double)
+
+Parameter ``num_threads``:
+    the number of concurrent clusters, non-positive uses the number of
+    hardware threads.
+
+Returns:
+    true if completed, false if stopped by the active
+    CancellationToken.
+
+)doc";
+
+static const char *__doc_Domain_create_mesh_sweep =
+R"doc(Creates one mesh for each mesh resolution, reusing the polyhedral mesh domains and the labeling oracle.
+
+Only the refinement is repeated for each resolution, and the refinements run concurrently. Each refinement has its own labeled mesh domain with the 1D features, while the polyhedral mesh domains, i.e. the surfaces and their AABB trees, are shared and only queried, as in the parallel refinement of CGAL. The meshes are returned as finalized :class:`Domain` objects, see :func:`finalize`, that can be queried, exuded and saved separately, and :func:`is_completed` is False for the meshes stopped by the active :class:`CancellationToken`. The meshes are created silently and then print as set for this object, see :func:`set_verbose`. The mesh stored in this object is not changed.
+
+:param mesh_resolutions: List of mesh resolutions, see :func:`create_mesh`.
+:param num_threads: The number of concurrent refinements, a non-positive value uses the number of hardware threads.
+
+:Returns: List of :class:`Domain` objects in the same order as mesh_resolutions.
+
+)doc";
+
+static const char *__doc_Domain_finalize =
+R"doc(Releases the meshing inputs, i.e. the polyhedral mesh domains with their AABB trees and the surface points stored for the bounding sphere.
+
+The mesh is kept, and can still be queried, exuded and saved. The functions create_mesh, lloyd, odt and perturb raise a PreconditionError after this call. Use when no further refinement is needed, and several large meshes are held at once.
+
+)doc";
+
+static const char *__doc_Domain_get_borders =
+R"doc(Returns the borders added to the :class:`Domain` object.
+
+:Returns: List of polylines, i.e. lists of :class:`Point_3`.
+
+)doc";
+
+static const char *__doc_Domain_get_counters =
+R"doc(Returns the number of labeling calls, inside evaluations and AABB tree constructions of the domain.
+
+Each labeling call evaluates if a point is inside each of the surfaces in the domain. The counters are useful to tune the error bound and the surface resolution.
+
+:Returns: Dictonary with counter names as keys and counts as values.
+
+)doc";
+
+static const char *__doc_Domain_get_data =
+R"doc(Returns the values of a data field.
+
+:param name: the name of the field.
+:returns: numpy array with shape (n) or (n, components).
+
+)doc";
+
+static const char *__doc_Domain_get_data_entity =
+R"doc(Returns the entity type of a data field.
+
+:param name: the name of the field.
+:returns: "vertex", "facet" or "cell".
+
+)doc";
+
+static const char *__doc_Domain_get_data_names =
+R"doc(Returns the names of the data fields.
+
+:returns: list of names.
+
+)doc";
+
+static const char *__doc_Domain_get_output_ordering =
+R"doc(Returns the numbering of the vertices and cells in the output, see :func:`set_output_ordering`.
+
+:Returns: "none", "hilbert" or "rcm".
+
+)doc";
+
+static const char *__doc_Domain_get_slice =
+R"doc(Intersects the cells of the mesh with a plane, and returns the sections as a tagged 2D mesh.
+
+The section of each cell is a triangle or a quadrilateral with the subdomain tag of the cell, and the edges between faces with different tags get the interface tags of the mesh. The 2D mesh does not need create_mesh and add_surface_domains, and can be written with Slice.save.
+
+:param plane: SVMTK Plane_3 object.
+:returns: SVMTK Slice object with the tagged 2D mesh.
+
+)doc";
+
+static const char *__doc_Domain_get_slice_2 =
+R"doc(Intersects the cells of the mesh with a plane defined by the plane equation ax + by + cz + d = 0, and returns the sections as a tagged 2D mesh.
+
+:param a: parameter in the plane equation.
+:param b: parameter in the plane equation.
+:param c: parameter in the plane equation.
+:param d: parameter in the plane equation.
+:returns: SVMTK Slice object with the tagged 2D mesh.
+
+)doc";
+
+static const char *__doc_Domain_get_slices =
+R"doc(Intersects the cells of the mesh with each plane concurrently, see get_slice.
+
+:param planes: list of SVMTK Plane_3 objects, e.g. parallel planes through a stack.
+:param num_threads: the number of threads, non-positive uses the number of hardware threads.
+:returns: list of SVMTK Slice objects in the same order as planes.
+
+)doc";
+
 static const char *__doc_Domain_get_subdomains =
 R"doc(Returns a set of integer that represents the cell tags in the mesh.
 
@@ -192,6 +429,8 @@ R"doc(Creates the mesh stored in the class attribute c3t3 using `CGAL mesh crite
 :param facet_distance: Sets teh upper-bound for the distance between the facet circumcenter and the center of its surface Delaunay ball.
 :param cell_radius_edge_ratio: Sets the upper-bound for the radius-edge ratio of the mesh tetrahedra.
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
 )doc";
 
 static const char *__doc_Domain_create_mesh_2 =
@@ -199,11 +438,15 @@ R"doc(Creates the mesh stored in the class attribute c3t3. The mesh criteria is
 
 :param mesh_resolution: Sets the mesh criteria parameters: cell_size, facet_size, edge_size and facet_distance, by dividing the minimum bounding radius of the mesh with the mesh resolution. 
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
 )doc";
 
 static const char *__doc_Domain_create_mesh_3 =
 R"doc(Creates the mesh stored in the class attribute c3t3. The mesh resolution is set automatic to the highest mesh resolution of the surface(s).
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
 )doc";
 
 static const char *__doc_Domain_dihedral_angles =
@@ -229,6 +472,9 @@ See also:
 :param time_limit: Sets, in seconds, a CPU time limit after which the optimization process is stopped.
 :sliver_bound: Sets a targeted lower-bound on dihedral angles of mesh cells.
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+:raises PreconditionError: if the mesh is not a regular triangulation, see :func:`is_regular`.
+
 )doc";
 
 static const char *__doc_Domain_get_boundaries =
@@ -260,6 +506,27 @@ R"doc(Returns a set of integer pairs that represents the surface facet tags in t
 :Returns: List of integer tuples that represents all the facet tags in the mesh.
 
 
+)doc";
+
+static const char *__doc_Domain_is_completed =
+R"doc(Returns False if the last meshing of this object was stopped by the active :class:`CancellationToken`, e.g. for the meshes of :func:`create_mesh_sweep`.
+
+:Returns: True if the last meshing was completed.
+
+)doc";
+
+static const char *__doc_Domain_is_finalized =
+R"doc(Returns True if the meshing inputs are released with finalize.
+
+:Returns: True if the meshing inputs are released.
+
+)doc";
+
+static const char *__doc_Domain_is_regular =
+R"doc(Returns True if the mesh is a regular triangulation. The meshes of :func:`refine` and of :func:`morph` without remeshing are not, and vertices can not be removed from them, e.g. by :func:`exude` or :func:`remove_subdomain`.
+
+:Returns: True if the mesh is a regular triangulation.
+
 )doc";
 
 static const char *__doc_Domain_lloyd =
@@ -276,6 +543,33 @@ Do not use lloyd after excude optimazation, it will cause failure.
 :param freeze_bound: vertex that has a displacement less than a given percentage of the length (the of its shortest incident edge, is frozen (i.e. is not relocated).
 :param do_freeze: - completes the freeze_bound parameter.
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
+)doc";
+
+static const char *__doc_Domain_memory_report =
+R"doc(Returns an estimate of the memory held by the domain, broken down by component.
+
+The components are the polyhedral mesh domains with their AABB trees, the surface points stored for the bounding sphere, the triangulation, the 1D features and corners of the mesh, the added borders and features, and the triangle and point data.
+
+:Returns: Dictonary with component names as keys and bytes as values, including the key "total".
+
+)doc";
+
+static const char *__doc_Domain_morph =
+R"doc(Moves the vertices of the mesh onto deformed surfaces with the same vertices and faces as the surfaces of the mesh, without remeshing.
+
+A boundary vertex is moved with the barycentric coordinates of its closest point on the reference surfaces, i.e. the surfaces from the constructor or the last morph, and so are the points of the borders and features. The displacement of the other vertices is the harmonic extension of the boundary displacement, solved with a sparse Cholesky factorization. The connectivity and the data fields of the mesh are kept.
+
+The moved mesh is in general not a regular triangulation, so it is finalized, see :func:`finalize` and :func:`is_regular`, and can be queried, saved and morphed again, but not exuded. If cells are inverted or have a minimum dihedral angle below the bound, the vertices inside these cells and the buffer layers around them are removed, and the triangulation is rebuilt from the other vertices to restore regularity. The mesh is then refined against the deformed surfaces and the moved borders and features, where the size criteria are only applied in the neighbourhood of the removed vertices.
+
+:param surfaces: the deformed list of SVMTK Surface objects, in the same order as in the constructor.
+:param min_dihedral_angle: the lower bound on the dihedral angles of the moved cells in degrees.
+:param buffer_layers: the number of cell layers around the bad cells that are remeshed.
+:param mesh_resolution: the mesh resolution of the remeshing, non-positive uses the resolution of the surfaces.
+:param error_bound: allowed error of the surface representation.
+:returns: the number of bad cells after the vertices are moved, i.e. 0 if the mesh is not remeshed.
+
 )doc";
 
 static const char *__doc_Domain_number_of_cells =
@@ -292,6 +586,14 @@ R"doc(Returns number of 1D polylines in stored volume mesh.
 
 )doc";
 
+static const char *__doc_Domain_number_of_data_entities =
+R"doc(Returns the number of vertices, facets or cells written with :func:`save`.
+
+:param entity: "vertex", "facet" or "cell".
+:returns: the number of entities.
+
+)doc";
+
 static const char *__doc_Domain_number_of_facets =
 R"doc(Returns number of facets, triangles, in stored volume mesh.
 
@@ -338,6 +640,32 @@ See also: `odt_optimize_mesh <https://doc.cgal.org/latest/Mesh_3/group__PkgMesh3
 :param freeze_bound: vertex that has a displacement less than a given percentage of the length (the of its shortest incident edge, is frozen (i.e. is not relocated).
 :paramdo_freeze: completes the freeze_bound parameter.
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
+)doc";
+
+static const char *__doc_Domain_optimize =
+R"doc(Runs the mesh optimizers until the mesh quality targets are met or the time budget is spent.
+
+The optimizers are run in the order odt, lloyd, perturb and exude. lloyd is only run if odt did not improve the minimum radius ratio, and after :func:`finalize` only exude is run. exude is skipped if the mesh is not a regular triangulation, see :func:`is_regular`. The quality is measured after each pass, and the optimization stops as soon as both targets are met. The time not used by a pass goes to the next passes.
+
+:param min_dihedral_angle: the target minimum dihedral angle in degrees, also used as the sliver bound of perturb and exude.
+:param min_radius_ratio: the target minimum radius ratio.
+:param time_budget: the total time budget in seconds.
+:returns: List of :class:`OptimizationPass` objects, one for each optimizer that was run.
+
+)doc";
+
+static const char *__doc_Domain_partition =
+R"doc(Partitions the cells of the mesh into parts with balanced number of cells and few facets between the parts, e.g. for distributed solvers.
+
+The graph of cells connected through facets is partitioned with METIS if SVMTK is built with SVMTK_USE_METIS, and otherwise with the bundled multilevel recursive bisection. The partition is stored for :func:`save_partitions` until the mesh is changed.
+
+:param num_parts: The number of parts.
+:param imbalance: The allowed ratio between the number of cells in a part and the average.
+
+:Returns: List with the part of each cell, in the order that the cells are written with :func:`save`.
+
 )doc";
 
 static const char *__doc_Domain_perturb =
@@ -348,6 +676,8 @@ See also: `perturb_mesh <https://doc.cgal.org/latest/Mesh_3/group__PkgMesh3Funct
 :param time_limit: Sets, in seconds, a CPU time limit after which the optimization process is stopped.
 :param sliver_bound: Sets targeted lower-bound on dihedral angles of mesh cells.
 
+:Returns: False if stopped by the active :class:`CancellationToken`, otherwise True.
+
 )doc";
 
 static const char *__doc_Domain_radius_ratios =
@@ -364,6 +694,61 @@ R"doc(Returns the maximum and minimum radius ratio of cells in mesh.
 
 )doc";
 
+static const char *__doc_Domain_refine =
+R"doc(Returns a copy of the mesh where each cell is split into 8 cells at the midpoints of its edges (red refinement).
+
+The vertices of the mesh are kept, and the subdomain, interface, curve and corner tags are inherited by the refined mesh. If only some subdomains are refined, the neighbouring cells are split into 2 or 4 cells so that the mesh stays conforming. The refined mesh is returned as a finalized Domain object, see :func:`finalize`, which can be queried and saved with all writers, but not remeshed, optimized or exuded, and subdomains can not be removed, see :func:`is_regular`.
+
+:param levels: the number of refinements.
+:param subdomains: list of subdomain tags of the refined cells, empty refines all cells.
+:param num_threads: the number of threads, non-positive uses the number of hardware threads.
+:returns: a finalized Domain object with the refined mesh.
+
+)doc";
+
+static const char *__doc_Domain_relabel_subdomains =
+R"doc(Changes the subdomain tags of the mesh without remeshing.
+
+The facets between cells that get the same tag are removed, and the facets of the changed cells get the interface of the new tags. The vertices are not moved.
+
+:param tags: dictionary from old subdomain tags to new non-zero subdomain tags, tags not in the dictionary are kept.
+:returns: the number of cells with changed tags.
+
+)doc";
+
+static const char *__doc_Domain_relabel_subdomains_2 =
+R"doc(Changes the subdomain tags of the mesh without remeshing, by classifying the centroids of the cells with a list of surfaces.
+
+The tag of a cell is given by the map of the surfaces that contain its centroid, and cells with tag 0, e.g. outside all surfaces, keep their tag. The centroids are classified concurrently.
+
+:param surfaces: list of SVMTK Surface objects.
+:param map: SVMTK SubdomainMap object for the surfaces.
+:param num_threads: the number of threads, non-positive uses the number of hardware threads.
+:returns: the number of cells with changed tags.
+
+)doc";
+
+static const char *__doc_Domain_remesh_subdomains =
+R"doc(Remeshes the subdomains with the given tags against an updated list of surfaces, and keeps the rest of the mesh.
+
+The vertices inside the subdomains and a buffer of cell layers around them are removed, except vertices that protect 1D features, and the mesh is refined again. The cells outside the removed region are not changed, so the remeshed region conforms to the rest of the mesh. The subdomain and interface tags of the whole mesh are recomputed against the updated surfaces.
+
+:param surfaces: the updated list of SVMTK Surface objects, in the same order as in the constructor.
+:param subdomains: list of subdomain tags of the remeshed cells.
+:param buffer_layers: the number of cell layers around the subdomains that are also remeshed.
+:param mesh_resolution: the mesh resolution, non-positive uses the resolution of the surfaces.
+:param error_bound: allowed error of the surface representation.
+:returns: True if completed, False if stopped by a cancellation.
+
+)doc";
+
+static const char *__doc_Domain_remove_data =
+R"doc(Removes a data field, if it exists.
+
+:param name: the name of the field.
+
+)doc";
+
 static const char *__doc_Domain_remove_subdomain =
 R"doc(Removes all cells in the mesh with a specified integer tag, but perserves the interface tags as if no cells were removed.
 
@@ -378,6 +763,11 @@ R"doc(Removes all cells in the mesh with tags in a list, but perserves the inter
 
 )doc";
 
+static const char *__doc_Domain_reset_counters =
+R"doc(Sets all query counters of the domain to zero.
+
+)doc";
+
 static const char *__doc_Domain_save =
 R"doc(Writes the mesh stored in the class attribute c3t3 to file.
 
@@ -389,6 +779,123 @@ The interface tags are loaded from :class:`SubdomainMap` added in the constructo
 )doc";
 
 
+static const char *__doc_Domain_save_partitions =
+R"doc(Writes each part of the partition to a separate medit file, with optional ghost layers.
+
+Part p is written to outpath_p.mesh, with outpath stripped of the extension .mesh. The ghost cells are the cells of other parts that share a vertex with the part, or with the previous ghost layer, and are written after the cells of the part. The file outpath_p.map lists the vertex number of each vertex, and the cell number and part of each cell, in the mesh written with :func:`save`.
+
+:param outpath: The path to the output files.
+:param ghost_layers: The number of ghost layers.
+:param save_1Dfeatures: Option to save the edges with tags.
+
+)doc";
+
+static const char *__doc_Domain_save_xdmf =
+R"doc(Writes the mesh and the data fields in the XDMF format, with the arrays in a binary file.
+
+The file outpath.xdmf contains the grid "mesh" with the tetrahedra, the subdomain tags and the vertex and cell data, and the grid "facets" with the triangles, the interface tags and the facet data. The arrays are written to outpath.bin in native byte order.
+
+:param outpath: the path to the output files, with or without the extension .xdmf.
+
+)doc";
+
+static const char *__doc_Domain_set_data =
+R"doc(Attaches a data field to the vertices, facets or cells of the mesh.
+
+The entities are in the order they are written with :func:`save`, i.e. the vertices and cells in the output ordering and the facets in the order of the Triangles section. The fields are kept through :func:`remove_subdomain` and :func:`set_output_ordering`, and are removed when the mesh is changed by :func:`create_mesh` or the mesh optimizers.
+
+:param name: the name of the field, replaces an existing field with the same name.
+:param entity: "vertex", "facet" or "cell".
+:param values: numpy array with shape (n) or (n, components), where n is :func:`number_of_data_entities`.
+
+)doc";
+
+static const char *__doc_Domain_set_output_ordering =
+R"doc(Sets the numbering of the vertices and cells in the files written with :func:`save` and :func:`save_partitions`, and of the cells in :func:`partition`.
+
+The option "hilbert" orders the vertices and the cells along a Hilbert curve, and the option "rcm" orders the vertices with reverse Cuthill-McKee, and the cells by their vertices. Both place neighbouring vertices and cells close in memory, which improves the cache efficiency of solvers that read the mesh. The facets are written in the same order as before.
+
+:param ordering: "none", "hilbert" or "rcm".
+
+:Raises: InvalidArgumentError if the ordering is unknown.
+
+)doc";
+
+static const char *__doc_Domain_set_region_of_interest =
+R"doc(Restricts the meshing to an iso-cuboid, i.e. points outside the box get the label 0 without evaluating the surfaces, and the bounding box of the mesh domain is clipped to the box.
+
+The facets of the cut have the surface patch (tag, -1), and get their own interface tag. With a SubdomainMap with interfaces, the cut tag is set with add_interface. The curves where the boundary of the region cuts the surfaces are protected as 1D features, so that the cut follows them instead of being resolved by refinement.
+
+:param xmin: the minimum x coordinate of the box.
+:param ymin: the minimum y coordinate of the box.
+:param zmin: the minimum z coordinate of the box.
+:param xmax: the maximum x coordinate of the box.
+:param ymax: the maximum y coordinate of the box.
+:param zmax: the maximum z coordinate of the box.
+
+)doc";
+
+static const char *__doc_Domain_set_region_of_interest_2 =
+R"doc(Restricts the meshing to a sphere.
+
+:param x: the x coordinate of the center.
+:param y: the y coordinate of the center.
+:param z: the z coordinate of the center.
+:param radius: the radius of the sphere.
+
+)doc";
+
+static const char *__doc_Domain_set_region_of_interest_3 =
+R"doc(Restricts the meshing to the inside of a closed surface.
+
+:param surface: the :class:`Surface` object that bounds the region.
+
+)doc";
+
+static const char *__doc_Domain_set_verbose =
+R"doc(Sets if the meshing progress is printed to stdout, which is the default.
+
+:param value: False to mesh silently.
+
+)doc";
+
+static const char *__doc_Domain_write_facet_data =
+R"doc(Writes a facet data field to file, with one line per facet in the order of the Triangles section written with :func:`save`.
+
+:param filename: the path to the output file.
+:param name: the name of the facet data field, default "collision_distance".
+
+)doc";
+
+static const char *__doc_MeshingJob =
+R"doc(A single meshing task for :class:`BatchMesher`.
+
+The attributes are the input surfaces, the subdomain map, the mesh resolution, the post-processing steps ("lloyd", "odt", "exude" or "perturb"), the output path, the error bound, save_1Dfeatures and an optional memory estimate in bytes.
+
+)doc";
+
+static const char *__doc_MeshingJob_MeshingJob =
+R"doc(Constructs a meshing job.
+
+:param surfaces: List of :class:`Surface` objects.
+:param map: :class:`SubdomainMap` object, None uses the default map.
+:param mesh_resolution: The mesh resolution, a non-positive value uses the surface resolution.
+:param post_processing: List of post-processing steps, i.e. "lloyd", "odt", "exude" or "perturb", applied in order.
+:param output: The path to the output file, an empty string skips saving the mesh.
+:param error_bound: Allowed error of the surface representation.
+
+)doc";
+
+static const char *__doc_MeshingResult =
+R"doc(The outcome of a :class:`MeshingJob`, with the attributes completed, number_of_cells, seconds, memory and error.
+
+)doc";
+
+static const char *__doc_OptimizationPass =
+R"doc(A mesh optimizer run by :func:`Domain.optimize`, with the attributes optimizer, time_limit, seconds, completed, and the minimum dihedral angle and radius ratio before and after the pass.
+
+)doc";
+
 static const char *__doc_Plane3 =
 R"doc(Wrapper for `CGAL Plane_3 class <https://doc.cgal.org/latest/Kernel_23/classCGAL_1_1Plane__3.html>`_, with plane equation defined as :math:`h : ax+by+cz+d = 0.`  
         
@@ -763,6 +1270,11 @@ Attributes:
 
 )doc";
 
+static const char *__doc_SurfaceClash =
+R"doc(A pair of input surfaces that intersect or violate the nesting of the subdomain map, found by :func:`Domain.check_surfaces`, with the attributes first, second, type (self_intersection, intersection or nesting), count (the number of intersecting triangle pairs) and location.
+
+)doc";
+
 static const char *__doc_Surface_Surface = R"doc(Constructs an empty SVMTK Surface object.)doc";
 
 static const char *__doc_Surface_Surface_2 =
@@ -1016,6 +1528,13 @@ R"doc(Finds a specified number mesh points that are closest to a point not on th
 
 )doc";
 
+static const char *__doc_Surface_get_counters =
+R"doc(Returns the number of inside queries, AABB and kd-tree constructions and nearest neighbour searches performed by the surface.
+
+:Returns: Dictonary with counter names as keys and counts as values.
+
+)doc";
+
 static const char *__doc_Surface_get_points =
 R"doc(Returns the points of the surfaces mesh.
 
@@ -1323,6 +1842,11 @@ See also:
 
 
 
+static const char *__doc_Surface_reset_counters =
+R"doc(Sets all query counters of the surface to zero.
+
+)doc";
+
 static const char *__doc_Surface_save =
 R"doc(Saves the surface mesh to file. Valid file formats: off and stl.
 
@@ -1503,6 +2027,62 @@ R"doc(Creates a :class`Vector_3` object as difference between two points.
 
 )doc";
 
+static const char *__doc_Workload =
+R"doc(A synthetic multi-surface scene for benchmarks and stress tests of the meshing, see :func:`make_workload`.
+
+The attributes are the name of the scene, the list of :class:`Surface` objects, the matching :class:`SubdomainMap` and the edge length of the surfaces.
+
+)doc";
+
+static const char *__doc_Workload_number_of_triangles =
+R"doc(Returns the total number of triangles of the surfaces.
+
+:Returns: The number of triangles.
+
+)doc";
+
+static const char *__doc_clear_timings =
+R"doc(Removes all recorded phase timings.
+
+)doc";
+
+static const char *__doc_enable_timings =
+R"doc(Enables or disables recording of phase timings.
+
+Timed phases include the construction of :class:`Domain` objects, the Mesh_3 refinement in :func:`Domain.create_mesh`, the mesh optimizers, :func:`Domain.save` and the most time-consuming :class:`Surface` operations. Recording is disabled by default, and has negligible overhead when disabled.
+
+:param enable: True to enable recording. 
+
+)doc";
+
+static const char *__doc_get_timings =
+R"doc(Returns the accumulated time of each recorded phase.
+
+:Returns: Dictonary with phase names as keys and time in seconds as values.
+
+)doc";
+
+static const char *__doc_make_workload =
+R"doc(Creates a synthetic scene for benchmarks and stress tests of the meshing.
+
+The surfaces are generated with the :class:`Surface` primitives, with an edge length chosen so that the total number of triangles is approximately number_of_triangles, and the workload is reproducible for a given seed. The scenes are:
+
+- "nested_shells": nested spheres with radius 1, 2, ..., and one subdomain between each pair of spheres.
+- "packed_spheres": non-overlapping spheres with random radii at jittered positions in a cubic grid.
+- "touching_blocks": unit cubes in a cubic grid, where neighbouring cubes share a face.
+- "tubular_network": a box with overlapping tubes along the edges of a cubic lattice, with tag 1 in the box and tag 2 in the tubes.
+
+:param scene: "nested_shells", "packed_spheres", "touching_blocks" or "tubular_network".
+:param number_of_surfaces: The number of surfaces.
+:param number_of_triangles: The target total number of triangles.
+:param seed: The seed of the random scenes.
+
+:Returns: A :class:`Workload` object.
+
+:Raises: InvalidArgumentError if the scene is unknown, or the numbers are not positive.
+
+)doc";
+
 static const char *__doc_separate_close_surfaces =
 R"doc(Separates two close surfaces outside a third surface. 
 
@@ -1582,6 +2162,15 @@ Requires that the surfaces overlap. First, surface vertices inside the other sur
 
 )doc";
 
+static const char *__doc_write_chrome_trace =
+R"doc(Writes the recorded phases to file in the Chrome trace event format.
+
+The file can be inspected with chrome://tracing or `Perfetto <https://ui.perfetto.dev>`_.
+
+:param filename: Path to the output json file.
+
+)doc";
+
 #if defined(__GNUG__)
 #pragma GCC diagnostic pop
 #endif
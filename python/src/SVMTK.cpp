@@ -1,12 +1,19 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pybind11/operators.h>
+#include <pybind11/stl.h>
 
 #include "docstrings.h"
 #include "Surface.h"
 #include "Domain.h"
 #include "Slice.h"
+#include "Batch.h"
+#include "Workload.h"
 #include <CGAL/IO/read_ply_points.h>
+#include <csignal>
+#ifndef _WIN32
+#include <signal.h>
+#endif
 
 namespace py = pybind11;
 
@@ -89,6 +96,192 @@ std::shared_ptr<Surface> Wrapper_convex_hull(py::array_t<double> point3_array)
     return surface;
 }
 
+void Wrapper_set_data(Domain &domain, std::string name, std::string entity,
+                      py::array_t<double, py::array::c_style | py::array::forcecast> values)
+{
+    py::buffer_info buffer = values.request();
+
+    if (buffer.ndim != 1 and buffer.ndim != 2)
+        throw std::runtime_error("Expected 1d or 2d array");
+
+    int components = buffer.ndim == 2 ? static_cast<int>(buffer.shape[1]) : 1;
+    double *ptr_values = (double *)buffer.ptr;
+    domain.set_data(name, entity, std::vector<double>(ptr_values, ptr_values + buffer.size), components);
+}
+
+py::array_t<double> Wrapper_get_data(Domain &domain, std::string name)
+{
+    std::vector<double> values = domain.get_data(name);
+    py::ssize_t components = domain.get_data_components(name);
+    py::array_t<double> result;
+    if (components == 1)
+        result = py::array_t<double>(values.size());
+    else
+        result = py::array_t<double>({static_cast<py::ssize_t>(values.size()) / components, components});
+    std::copy(values.begin(), values.end(), result.mutable_data());
+    return result;
+}
+
+/* -- Cancellation */
+/**
+ * The tokens that were active before each with-statement on the current thread, restored on exit.
+ */
+static std::vector<CancellationToken *> &active_tokens()
+{
+    static thread_local std::vector<CancellationToken *> tokens;
+    return tokens;
+}
+
+static std::atomic<CancellationToken *> interrupt_token{nullptr};
+static volatile std::sig_atomic_t interrupt_received = 0;
+
+/**
+ * Forwards SIGINT (KeyboardInterrupt) to the active CancellationToken while a long running
+ * operation is executed, and raises KeyboardInterrupt when the operation returns.
+ * A temporary token is activated if no token is active.
+ * The signal handler is only installed from the Python main thread, where Python handles SIGINT,
+ * by the first of several concurrent operations, and not if SIGINT is ignored. The previous handler
+ * is restored when the operation returns, unless the handler was replaced during the operation.
+ */
+class Interrupt_guard
+{
+public:
+    Interrupt_guard()
+    {
+        if (!CancellationToken::current())
+            scope.reset(new CancellationScope(local_token));
+        if (!is_main_thread())
+            return;
+        CancellationToken *expected = nullptr;
+        if (!interrupt_token.compare_exchange_strong(expected, CancellationToken::current()))
+            return;
+        interrupt_received = 0;
+        installed = install();
+        if (!installed)
+            interrupt_token.store(nullptr);
+    }
+
+    ~Interrupt_guard()
+    {
+        if (installed)
+        {
+            uninstall();
+            interrupt_token.store(nullptr);
+        }
+    }
+
+    void check()
+    {
+        if (installed and interrupt_received)
+        {
+            interrupt_received = 0;
+            PyErr_SetNone(PyExc_KeyboardInterrupt);
+            throw py::error_already_set();
+        }
+    }
+
+private:
+    static void handler(int)
+    {
+        interrupt_received = 1;
+        CancellationToken *token = interrupt_token.load();
+        if (token)
+            token->cancel();
+    }
+
+    static bool is_main_thread()
+    {
+        py::module_ threading = py::module_::import("threading");
+        return threading.attr("current_thread")().is(threading.attr("main_thread")());
+    }
+
+#ifdef _WIN32
+    bool install()
+    {
+        previous_handler = std::signal(SIGINT, &Interrupt_guard::handler);
+        if (previous_handler == SIG_ERR)
+            return false;
+        if (previous_handler == SIG_IGN)
+        {
+            std::signal(SIGINT, SIG_IGN);
+            return false;
+        }
+        return true;
+    }
+
+    void uninstall()
+    {
+        void (*current)(int) = std::signal(SIGINT, previous_handler);
+        if (current != &Interrupt_guard::handler)
+            std::signal(SIGINT, current);
+    }
+
+    void (*previous_handler)(int) = SIG_DFL;
+#else
+    bool install()
+    {
+        if (sigaction(SIGINT, nullptr, &previous_action) != 0)
+            return false;
+        if (!(previous_action.sa_flags & SA_SIGINFO) and previous_action.sa_handler == SIG_IGN)
+            return false;
+        struct sigaction action;
+        action.sa_handler = &Interrupt_guard::handler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = 0;
+        return sigaction(SIGINT, &action, nullptr) == 0;
+    }
+
+    void uninstall()
+    {
+        struct sigaction current;
+        if (sigaction(SIGINT, nullptr, &current) == 0 and !(current.sa_flags & SA_SIGINFO) and current.sa_handler == &Interrupt_guard::handler)
+            sigaction(SIGINT, &previous_action, nullptr);
+    }
+
+    struct sigaction previous_action;
+#endif
+
+    CancellationToken local_token;
+    std::unique_ptr<CancellationScope> scope;
+    bool installed = false;
+};
+
+/**
+ * Wraps a long running method or function, such that it runs without the GIL
+ * and can be interrupted with SIGINT.
+ */
+template <typename Return, typename Class, typename... Args>
+auto interruptible(Return (Class::*method)(Args...))
+{
+    return [method](Class &self, Args... args) -> Return
+    {
+        Interrupt_guard guard;
+        Return result = [&]()
+        {
+            py::gil_scoped_release release;
+            return (self.*method)(std::forward<Args>(args)...);
+        }();
+        guard.check();
+        return result;
+    };
+}
+
+template <typename Return, typename... Args>
+auto interruptible(Return (*function)(Args...))
+{
+    return [function](Args... args) -> Return
+    {
+        Interrupt_guard guard;
+        Return result = [&]()
+        {
+            py::gil_scoped_release release;
+            return function(std::forward<Args>(args)...);
+        }();
+        guard.check();
+        return result;
+    };
+}
+
 PYBIND11_MODULE(SVMTK, m)
 {
     m.doc() = "Surface Volume Meshing Toolkit";
@@ -122,6 +315,30 @@ PYBIND11_MODULE(SVMTK, m)
                                               ex4(e.what());
                                           } });
 
+    py::class_<CancellationToken, std::shared_ptr<CancellationToken>>(m, "CancellationToken", DOC(CancellationToken))
+        .def(py::init<>(), DOC(CancellationToken, CancellationToken))
+        .def(py::init([](double time_budget)
+                      {
+                          auto token = std::make_shared<CancellationToken>();
+                          token->set_time_budget(time_budget);
+                          return token; }),
+             py::arg("time_budget"), DOC(CancellationToken, CancellationToken, 2))
+        .def("cancel", &CancellationToken::cancel, DOC(CancellationToken, cancel))
+        .def("reset", &CancellationToken::reset, DOC(CancellationToken, reset))
+        .def("is_cancelled", &CancellationToken::is_cancelled, DOC(CancellationToken, is_cancelled))
+        .def("set_time_budget", &CancellationToken::set_time_budget, py::arg("seconds"), DOC(CancellationToken, set_time_budget))
+        .def("remaining_time", &CancellationToken::remaining_time, DOC(CancellationToken, remaining_time))
+        .def("__enter__", [](std::shared_ptr<CancellationToken> token)
+             {
+                 active_tokens().push_back(token->activate());
+                 return token; })
+        .def("__exit__", [](CancellationToken &, py::object, py::object, py::object)
+             {
+                 if (active_tokens().empty())
+                     return;
+                 CancellationToken::restore(active_tokens().back());
+                 active_tokens().pop_back(); });
+
     py::class_<Vector_3, std::shared_ptr<Vector_3>>(m, "Vector_3", DOC(Vector3))
         .def(py::init<double, double, double>(), py::arg("x"), py::arg("y"), py::arg("z"), DOC(Vector3, Vector3))
         .def(py::init<Point_3, Point_3>(), py::arg("source"), py::arg("target"), DOC(Vector3, Vector3, 2))
@@ -204,16 +421,17 @@ PYBIND11_MODULE(SVMTK, m)
         .def(py::init<Point_3, Vector_3>(), DOC(Slice, Slice, 3))
         .def(py::init<double, double, double, double>(), DOC(Slice, Slice, 4))
 
-        .def("create_mesh", py::overload_cast<double>(&Slice::create_mesh), DOC(Slice, create_mesh))
-        .def("create_mesh", py::overload_cast<double, double>(&Slice::create_mesh), DOC(Slice, create_mesh, 2))
+        .def("create_mesh", py::overload_cast<double>(&Slice::create_mesh), py::call_guard<py::gil_scoped_release>(), DOC(Slice, create_mesh))
+        .def("create_mesh", py::overload_cast<double, double>(&Slice::create_mesh), py::call_guard<py::gil_scoped_release>(), DOC(Slice, create_mesh, 2))
         .def("simplify", &Slice::simplify, DOC(Slice, simplify))
-        .def("save", &Slice::save, DOC(Slice, save))
-        .def("slice_surfaces", &Slice::slice_surfaces<Surface>, DOC(Slice, slice_surfaces))
+        .def("save", &Slice::save, py::call_guard<py::gil_scoped_release>(), DOC(Slice, save))
+        .def("slice_surfaces", &Slice::slice_surfaces<Surface>, py::call_guard<py::gil_scoped_release>(), DOC(Slice, slice_surfaces))
         .def("export_as_surface", &Slice::export_as_surface<Surface>, DOC(Slice, export_as_surface))
-        .def("add_surface_domains", py::overload_cast<std::vector<Surface>, AbstractMap &>(&Slice::add_surface_domains<Surface>), DOC(Slice, add_surface_domains))
-        .def("add_surface_domains", py::overload_cast<std::vector<Surface>>(&Slice::add_surface_domains<Surface>), DOC(Slice, add_surface_domains, 2))
+        .def("add_surface_domains", py::overload_cast<std::vector<Surface>, AbstractMap &>(&Slice::add_surface_domains<Surface>), py::call_guard<py::gil_scoped_release>(), DOC(Slice, add_surface_domains))
+        .def("add_surface_domains", py::overload_cast<std::vector<Surface>>(&Slice::add_surface_domains<Surface>), py::call_guard<py::gil_scoped_release>(), DOC(Slice, add_surface_domains, 2))
         .def("number_of_constraints", &Slice::number_of_constraints, DOC(Slice, number_of_constraints))
         .def("number_of_subdomains", &Slice::number_of_subdomains, DOC(Slice, number_of_subdomains))
+        .def("get_subdomains", &Slice::get_subdomains, DOC(Slice, get_subdomains))
         .def("number_of_faces", &Slice::number_of_faces, DOC(Slice, number_of_faces))
         .def("connected_components", &Slice::connected_components, DOC(Slice, connected_components))
         .def("keep_largest_connected_component", &Slice::keep_largest_connected_component, DOC(Slice, keep_largest_connected_component))
@@ -226,7 +444,7 @@ PYBIND11_MODULE(SVMTK, m)
 
     py::class_<Surface, std::shared_ptr<Surface>>(m, "Surface", DOC(Surface))
         .def(py::init<>(), DOC(Surface, Surface))
-        .def(py::init<std::string &>(), py::arg("filename"), DOC(Surface, Surface, 2))
+        .def(py::init<std::string &>(), py::arg("filename"), py::call_guard<py::gil_scoped_release>(), DOC(Surface, Surface, 2))
         .def(py::init<Surface &>(), py::arg("surf"), DOC(Surface, Surface, 3))
         .def("__copy__", [](const Surface &self)
              { return Surface(self); })
@@ -234,11 +452,11 @@ PYBIND11_MODULE(SVMTK, m)
              { return Surface(self); })
         .def("assign", &Surface::operator=)
         //.def(py::self + Surface())
-        .def("keep_largest_connected_component", &Surface::keep_largest_connected_component, DOC(Surface, keep_largest_connected_component))
+        .def("keep_largest_connected_component", &Surface::keep_largest_connected_component, py::call_guard<py::gil_scoped_release>(), DOC(Surface, keep_largest_connected_component))
         .def("repair_self_intersections", &Surface::repair_self_intersections, py::arg("volume_threshold") = 0.01, py::arg("cap_threshold") = 170,
-             py::arg("needle_threshold") = 2.7, py::arg("collapse_threshold") = 0.14, DOC(Surface, repair_self_intersections))
+             py::arg("needle_threshold") = 2.7, py::arg("collapse_threshold") = 0.14, py::call_guard<py::gil_scoped_release>(), DOC(Surface, repair_self_intersections))
 
-        .def("remove_small_components", &Surface::remove_small_components, py::arg("volume_threshold") = 30, DOC(Surface, remove_small_components))
+        .def("remove_small_components", &Surface::remove_small_components, py::arg("volume_threshold") = 30, py::call_guard<py::gil_scoped_release>(), DOC(Surface, remove_small_components))
         .def("implicit_surface", &Surface::implicit_surface<Surface_implicit_function>, py::arg("implicit_function"), py::arg("bounding_sphere_radius"),
              py::arg("angular_bound") = 30, py::arg("radius_bound") = 0.1, py::arg("distance_bound") = 0.1, DOC(Surface, implicit_surface))
 
@@ -247,65 +465,65 @@ PYBIND11_MODULE(SVMTK, m)
              py::arg("x1"),
              py::arg("x2"),
              py::arg("x3"),
-             py::arg("preserve_manifold") = true, DOC(Surface, clip))
+             py::arg("preserve_manifold") = true, py::call_guard<py::gil_scoped_release>(), DOC(Surface, clip))
 
-        .def("clip", py::overload_cast<Point_3, Vector_3, bool>(&Surface::clip), py::arg("point"), py::arg("vector"), py::arg("preserve_manifold") = true, DOC(Surface, clip, 2))
-        .def("clip", py::overload_cast<Plane_3, bool>(&Surface::clip), py::arg("plane"), py::arg("preserve_manifold") = true)
-        .def("clip", py::overload_cast<Surface, bool, bool>(&Surface::clip), py::arg("surface"), py::arg("invert") = false, py::arg("preserve_manifold") = true, DOC(Surface, clip, 3))
+        .def("clip", py::overload_cast<Point_3, Vector_3, bool>(&Surface::clip), py::arg("point"), py::arg("vector"), py::arg("preserve_manifold") = true, py::call_guard<py::gil_scoped_release>(), DOC(Surface, clip, 2))
+        .def("clip", py::overload_cast<Plane_3, bool>(&Surface::clip), py::arg("plane"), py::arg("preserve_manifold") = true, py::call_guard<py::gil_scoped_release>())
+        .def("clip", py::overload_cast<Surface, bool, bool>(&Surface::clip), py::arg("surface"), py::arg("invert") = false, py::arg("preserve_manifold") = true, py::call_guard<py::gil_scoped_release>(), DOC(Surface, clip, 3))
         .def("clip", py::overload_cast<Point_3, Vector_3, double, bool, bool>(&Surface::clip),
-             py::arg("point"), py::arg("vector"), py::arg("radius"), py::arg("invert") = false, py::arg("preserve_manifold") = true, DOC(Surface, clip, 4))
+             py::arg("point"), py::arg("vector"), py::arg("radius"), py::arg("invert") = false, py::arg("preserve_manifold") = true, py::call_guard<py::gil_scoped_release>(), DOC(Surface, clip, 4))
 
         //.def("clipX", &Surface::clipX ) // TODO: TEST
-        .def("get_slice", py::overload_cast<double, double, double, double>(&Surface::get_slice<Slice>), DOC(Surface, get_slice))
-        .def("get_slice", py::overload_cast<Plane_3>(&Surface::get_slice<Slice>), DOC(Surface, get_slice, 2))
+        .def("get_slice", py::overload_cast<double, double, double, double>(&Surface::get_slice<Slice>), py::call_guard<py::gil_scoped_release>(), DOC(Surface, get_slice))
+        .def("get_slice", py::overload_cast<Plane_3>(&Surface::get_slice<Slice>), py::call_guard<py::gil_scoped_release>(), DOC(Surface, get_slice, 2))
         //.def("get_slice", py::overload_cast<Point_3,Vector_3>(&Surface::get_slice<Slice>),DOC(Surface,get_slice,3))
 
         .def("clear", &Surface::clear, DOC(Surface, clear))
-        .def("intersection", &Surface::surface_intersection, DOC(Surface, surface_intersection))
-        .def("union", &Surface::surface_union, DOC(Surface, surface_union))
-        .def("difference", &Surface::surface_difference, DOC(Surface, surface_difference))
+        .def("intersection", &Surface::surface_intersection, py::call_guard<py::gil_scoped_release>(), DOC(Surface, surface_intersection))
+        .def("union", &Surface::surface_union, py::call_guard<py::gil_scoped_release>(), DOC(Surface, surface_union))
+        .def("difference", &Surface::surface_difference, py::call_guard<py::gil_scoped_release>(), DOC(Surface, surface_difference))
         .def("span", &Surface::span, DOC(Surface, span))
-        .def("save", &Surface::save, DOC(Surface, save))
-        .def("fill_holes", &Surface::fill_holes, DOC(Surface, fill_holes))
-        .def("triangulate_faces", &Surface::triangulate_faces, DOC(Surface, triangulate_faces))
-        .def("isotropic_remeshing", py::overload_cast<double, unsigned int, bool>(&Surface::isotropic_remeshing), DOC(Surface, isotropic_remeshing))
+        .def("save", &Surface::save, py::call_guard<py::gil_scoped_release>(), DOC(Surface, save))
+        .def("fill_holes", &Surface::fill_holes, py::call_guard<py::gil_scoped_release>(), DOC(Surface, fill_holes))
+        .def("triangulate_faces", &Surface::triangulate_faces, py::call_guard<py::gil_scoped_release>(), DOC(Surface, triangulate_faces))
+        .def("isotropic_remeshing", py::overload_cast<double, unsigned int, bool>(&Surface::isotropic_remeshing), py::call_guard<py::gil_scoped_release>(), DOC(Surface, isotropic_remeshing))
         .def("adjust_boundary", &Surface::adjust_boundary, DOC(Surface, adjust_boundary))
-        .def("smooth_laplacian", &Surface::smooth_laplacian, DOC(Surface, smooth_laplacian))
-        .def("smooth_taubin", &Surface::smooth_taubin, DOC(Surface, smooth_taubin))
-        .def("smooth_shape", &Surface::smooth_shape, DOC(Surface, smooth_shape))
-        .def("make_cube", py::overload_cast<Point_3, Point_3, double>(&Surface::make_cube), DOC(Surface, make_cube))
+        .def("smooth_laplacian", &Surface::smooth_laplacian, py::call_guard<py::gil_scoped_release>(), DOC(Surface, smooth_laplacian))
+        .def("smooth_taubin", &Surface::smooth_taubin, py::call_guard<py::gil_scoped_release>(), DOC(Surface, smooth_taubin))
+        .def("smooth_shape", &Surface::smooth_shape, py::call_guard<py::gil_scoped_release>(), DOC(Surface, smooth_shape))
+        .def("make_cube", py::overload_cast<Point_3, Point_3, double>(&Surface::make_cube), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cube))
         .def("make_cube", py::overload_cast<double, double, double, double, double, double, double>(&Surface::make_cube),
-             py::arg("x0"), py::arg("y0"), py::arg("z0"), py::arg("x1"), py::arg("y1"), py::arg("z1"), py::arg("edge_length"), DOC(Surface, make_cube, 2))
+             py::arg("x0"), py::arg("y0"), py::arg("z0"), py::arg("x1"), py::arg("y1"), py::arg("z1"), py::arg("edge_length"), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cube, 2))
 
-        .def("make_cone", py::overload_cast<double, double, double, double, double, double, double, double, double>(&Surface::make_cone), DOC(Surface, make_cone))
-        .def("make_cone", py::overload_cast<Point_3, Point_3, double, double, double>(&Surface::make_cone), DOC(Surface, make_cone, 2))
+        .def("make_cone", py::overload_cast<double, double, double, double, double, double, double, double, double>(&Surface::make_cone), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cone))
+        .def("make_cone", py::overload_cast<Point_3, Point_3, double, double, double>(&Surface::make_cone), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cone, 2))
 
-        .def("make_cylinder", py::overload_cast<double, double, double, double, double, double, double, double>(&Surface::make_cylinder), DOC(Surface, make_cylinder))
-        .def("make_cylinder", py::overload_cast<Point_3, Point_3, double, double>(&Surface::make_cylinder), DOC(Surface, make_cylinder, 2))
+        .def("make_cylinder", py::overload_cast<double, double, double, double, double, double, double, double>(&Surface::make_cylinder), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cylinder))
+        .def("make_cylinder", py::overload_cast<Point_3, Point_3, double, double>(&Surface::make_cylinder), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_cylinder, 2))
 
-        .def("make_sphere", py::overload_cast<double, double, double, double, double>(&Surface::make_sphere), DOC(Surface, make_sphere))
-        .def("make_sphere", py::overload_cast<Point_3, double, double>(&Surface::make_sphere), DOC(Surface, make_sphere, 2))
+        .def("make_sphere", py::overload_cast<double, double, double, double, double>(&Surface::make_sphere), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_sphere))
+        .def("make_sphere", py::overload_cast<Point_3, double, double>(&Surface::make_sphere), py::call_guard<py::gil_scoped_release>(), DOC(Surface, make_sphere, 2))
 
-        .def("make_circle_in_plane", py::overload_cast<double, double, double, double, double, double, double, double>(&Surface::make_circle_in_plane))
-        .def("make_circle_in_plane", py::overload_cast<Point_3, Vector_3, double, double>(&Surface::make_circle_in_plane))
+        .def("make_circle_in_plane", py::overload_cast<double, double, double, double, double, double, double, double>(&Surface::make_circle_in_plane), py::call_guard<py::gil_scoped_release>())
+        .def("make_circle_in_plane", py::overload_cast<Point_3, Vector_3, double, double>(&Surface::make_circle_in_plane), py::call_guard<py::gil_scoped_release>())
 
         .def("is_point_inside", &Surface::is_point_inside, DOC(Surface, is_point_inside))
 
         .def("get_closest_points", &Surface::get_closest_points, py::arg("point"), py::arg("num") = 8, DOC(Surface, get_closest_points))
 
-        .def("mean_curvature_flow", &Surface::mean_curvature_flow, DOC(Surface, mean_curvature_flow))
+        .def("mean_curvature_flow", &Surface::mean_curvature_flow, py::call_guard<py::gil_scoped_release>(), DOC(Surface, mean_curvature_flow))
 
-        .def("get_shortest_surface_path", py::overload_cast<double, double, double, double, double, double>(&Surface::get_shortest_surface_path), DOC(Surface, get_shortest_surface_path))
-        .def("get_shortest_surface_path", py::overload_cast<Point_3, Point_3>(&Surface::get_shortest_surface_path), DOC(Surface, get_shortest_surface_path, 2))
+        .def("get_shortest_surface_path", py::overload_cast<double, double, double, double, double, double>(&Surface::get_shortest_surface_path), py::call_guard<py::gil_scoped_release>(), DOC(Surface, get_shortest_surface_path))
+        .def("get_shortest_surface_path", py::overload_cast<Point_3, Point_3>(&Surface::get_shortest_surface_path), py::call_guard<py::gil_scoped_release>(), DOC(Surface, get_shortest_surface_path, 2))
 
-        .def("embed", &Surface::embed, py::arg("other"), py::arg("adjustment") = -0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, embed))
-        .def("enclose", &Surface::enclose, py::arg("other"), py::arg("adjustment") = 0.8, py::arg("smoothing") = -0.4, py::arg("max_iter") = 400, DOC(Surface, enclose))
-        .def("expose", &Surface::expose, py::arg("other"), py::arg("adjustment") = -0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, expose))
-        .def("separate", &Surface::separate, py::arg("other"), py::arg("adjustment") = 0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, separate))
+        .def("embed", interruptible(&Surface::embed), py::arg("other"), py::arg("adjustment") = -0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, embed))
+        .def("enclose", interruptible(&Surface::enclose), py::arg("other"), py::arg("adjustment") = 0.8, py::arg("smoothing") = -0.4, py::arg("max_iter") = 400, DOC(Surface, enclose))
+        .def("expose", interruptible(&Surface::expose), py::arg("other"), py::arg("adjustment") = -0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, expose))
+        .def("separate", interruptible(&Surface::separate), py::arg("other"), py::arg("adjustment") = 0.8, py::arg("smoothing") = 0.4, py::arg("max_iter") = 400, DOC(Surface, separate))
 
-        .def("collapse_edges", py::overload_cast<const double>(&Surface::collapse_edges), DOC(Surface, collapse_edges))
-        .def("collapse_edges", py::overload_cast<>(&Surface::collapse_edges), DOC(Surface, collapse_edges, 2))
-        .def("split_edges", &Surface::split_edges, DOC(Surface, split_edges))
+        .def("collapse_edges", py::overload_cast<const double>(&Surface::collapse_edges), py::call_guard<py::gil_scoped_release>(), DOC(Surface, collapse_edges))
+        .def("collapse_edges", py::overload_cast<>(&Surface::collapse_edges), py::call_guard<py::gil_scoped_release>(), DOC(Surface, collapse_edges, 2))
+        .def("split_edges", &Surface::split_edges, py::call_guard<py::gil_scoped_release>(), DOC(Surface, split_edges))
 
         // TODO ReMOVE ??
         .def("intersecting_polylines", py::overload_cast<Point_3, Vector_3>(&Surface::polylines_in_plane))
@@ -315,88 +533,109 @@ PYBIND11_MODULE(SVMTK, m)
              py::arg("radius"),
              py::arg("length"),
              py::arg("edge_length"),
-             py::arg("use_normal"), DOC(Surface, cylindrical_extension))
+             py::arg("use_normal"), py::call_guard<py::gil_scoped_release>(), DOC(Surface, cylindrical_extension))
         .def("extension", py::overload_cast<const Point_3 &, double, double, double, bool>(&Surface::cylindrical_extension), py::arg("point"),
              py::arg("radius"),
              py::arg("length"),
              py::arg("edge_length"),
-             py::arg("use_normal"), DOC(Surface, cylindrical_extension, 2))
-        .def("connection", &Surface::cylindrical_connection, DOC(Surface, cylindrical_connection))
+             py::arg("use_normal"), py::call_guard<py::gil_scoped_release>(), DOC(Surface, cylindrical_extension, 2))
+        .def("connection", &Surface::cylindrical_connection, py::call_guard<py::gil_scoped_release>(), DOC(Surface, cylindrical_connection))
 
-        .def("separate_narrow_gaps", &Surface::separate_narrow_gaps, py::arg("adjustment") = -0.5, py::arg("smoothing") = 0.0, py::arg("max_iter") = 400, DOC(Surface, separate_narrow_gaps))
-        .def("separate_close_vertices", &Surface::separate_close_vertices, py::arg("adjustment") = 0.5, py::arg("max_iter") = 400, DOC(Surface, separate_close_vertices))
+        .def("separate_narrow_gaps", interruptible(&Surface::separate_narrow_gaps), py::arg("adjustment") = -0.5, py::arg("smoothing") = 0.0, py::arg("max_iter") = 400, DOC(Surface, separate_narrow_gaps))
+        .def("separate_close_vertices", interruptible(&Surface::separate_close_vertices), py::arg("adjustment") = 0.5, py::arg("max_iter") = 400, DOC(Surface, separate_close_vertices))
 
         .def("reconstruct", py::overload_cast<double, double, double>(&Surface::reconstruct),
-             py::arg("angular_bound") = 20, py::arg("radius_bound") = 0.1, py::arg("distance_bound") = 0.1, DOC(Surface, reconstruct))
+             py::arg("angular_bound") = 20, py::arg("radius_bound") = 0.1, py::arg("distance_bound") = 0.1, py::call_guard<py::gil_scoped_release>(), DOC(Surface, reconstruct))
 
         .def("reconstruct", py::overload_cast<std::string, double, double, double>(&Surface::reconstruct),
-             py::arg("filename"), py::arg("angular_bound") = 20, py::arg("radius_bound") = 0.1, py::arg("distance_bound") = 0.1, DOC(Surface, reconstruct, 2))
+             py::arg("filename"), py::arg("angular_bound") = 20, py::arg("radius_bound") = 0.1, py::arg("distance_bound") = 0.1, py::call_guard<py::gil_scoped_release>(), DOC(Surface, reconstruct, 2))
 
-        .def("convex_hull", &Surface::convex_hull, DOC(Surface, convex_hull))
+        .def("convex_hull", &Surface::convex_hull, py::call_guard<py::gil_scoped_release>(), DOC(Surface, convex_hull))
         .def("num_faces", &Surface::num_faces, DOC(Surface, num_faces))
         .def("num_edges", &Surface::num_edges, DOC(Surface, num_edges))
-        .def("num_self_intersections", &Surface::num_self_intersections, DOC(Surface, num_self_intersections))
+        .def("num_self_intersections", &Surface::num_self_intersections, py::call_guard<py::gil_scoped_release>(), DOC(Surface, num_self_intersections))
         .def("num_vertices", &Surface::num_vertices, DOC(Surface, num_vertices))
         .def("distance", &Surface::distance_to_point, DOC(Surface, distance_to_point))
+        .def("get_points", py::overload_cast<>(&Surface::get_points), DOC(Surface, get_points))
         .def("centeroid", &Surface::centeroid, DOC(Surface, centeroid))
         .def("area", &Surface::area, DOC(Surface, area))
-        .def("volume", &Surface::volume, DOC(Surface, volume));
+        .def("volume", &Surface::volume, DOC(Surface, volume))
+        .def("get_counters", &Surface::get_counters, DOC(Surface, get_counters))
+        .def("reset_counters", &Surface::reset_counters, DOC(Surface, reset_counters));
 
     py::class_<Domain, std::shared_ptr<Domain>>(m, "Domain", DOC(Domain))
-        .def(py::init<Surface &, double>(), py::arg("surface"), py::arg("error_bound") = 1.e-7, DOC(Domain, Domain))
-        .def(py::init<std::vector<Surface>, double>(), py::arg("surfaces"), py::arg("error_bound") = 1.e-7, DOC(Domain, Domain, 2))
-        .def(py::init<std::vector<Surface>, std::shared_ptr<AbstractMap>, double>(), py::arg("surfaces"), py::arg("map"), py::arg("error_bound") = 1.e-7, DOC(Domain, Domain, 3))
+        .def(py::init<Surface &, double, bool>(), py::arg("surface"), py::arg("error_bound") = 1.e-7, py::arg("validate") = false, py::call_guard<py::gil_scoped_release>(), DOC(Domain, Domain))
+        .def(py::init<std::vector<Surface>, double, bool>(), py::arg("surfaces"), py::arg("error_bound") = 1.e-7, py::arg("validate") = false, py::call_guard<py::gil_scoped_release>(), DOC(Domain, Domain, 2))
+        .def(py::init<std::vector<Surface>, std::shared_ptr<AbstractMap>, double, bool>(), py::arg("surfaces"), py::arg("map"), py::arg("error_bound") = 1.e-7, py::arg("validate") = false, py::call_guard<py::gil_scoped_release>(), DOC(Domain, Domain, 3))
 
-        .def("create_mesh", py::overload_cast<double, double, double, double, double, double>(&Domain::create_mesh),
+        .def("create_mesh", interruptible(py::overload_cast<double, double, double, double, double, double>(&Domain::create_mesh)),
              py::arg("edge_size"), py::arg("cell_size"), py::arg("facet_size"),
              py::arg("facet_angle"), py::arg("facet_distance"), py::arg("cell_radius_edge_ratio"), DOC(Domain, create_mesh))
 
-        .def("create_mesh", py::overload_cast<double>(&Domain::create_mesh), DOC(Domain, create_mesh, 2))
-        .def("create_mesh", py::overload_cast<>(&Domain::create_mesh), DOC(Domain, create_mesh, 3))
-
-        .def("radius_ratios_min_max", &Domain::radius_ratios_min_max, DOC(Domain, radius_ratios_min_max))
-        .def("dihedral_angles_min_max", &Domain::dihedral_angles_min_max, DOC(Domain, dihedral_angles_min_max))
-
-        .def("radius_ratios", &Domain::radius_ratios, DOC(Domain, radius_ratios))
-        .def("dihedral_angles", &Domain::dihedral_angles, DOC(Domain, dihedral_angles))
-
-        .def("get_boundary", &Domain::get_boundary<Surface>, py::arg("tag") = 0, DOC(Domain, get_boundary))
-        .def("get_boundaries", &Domain::get_boundaries<Surface>, DOC(Domain, get_boundaries))
-
-        //.def("get_borders", &Domain::get_borders) //TODO DOC(Domain,get_borders)) //TODO
-        .def("get_interface", &Domain::get_interface<Surface>) //, DOC(Domain,get_interface))
+        .def("create_mesh", interruptible(py::overload_cast<double>(&Domain::create_mesh)), DOC(Domain, create_mesh, 2))
+        .def("create_mesh", interruptible(py::overload_cast<>(&Domain::create_mesh)), DOC(Domain, create_mesh, 3))
+        .def("create_mesh_clusters", interruptible(&Domain::create_mesh_clusters), py::arg("mesh_resolution"), py::arg("num_threads") = 0, DOC(Domain, create_mesh_clusters))
+        .def("create_mesh_sweep", interruptible(&Domain::create_mesh_sweep), py::arg("mesh_resolutions"), py::arg("num_threads") = 0, DOC(Domain, create_mesh_sweep))
+        .def("remesh_subdomains", interruptible(&Domain::remesh_subdomains<Surface>), py::arg("surfaces"), py::arg("subdomains"), py::arg("buffer_layers") = 1,
+             py::arg("mesh_resolution") = 0., py::arg("error_bound") = 1.e-7, DOC(Domain, remesh_subdomains))
+        .def("morph", interruptible(&Domain::morph<Surface>), py::arg("surfaces"), py::arg("min_dihedral_angle") = 0., py::arg("buffer_layers") = 1,
+             py::arg("mesh_resolution") = 0., py::arg("error_bound") = 1.e-7, DOC(Domain, morph))
+        .def("get_slice", py::overload_cast<Plane_3>(&Domain::get_slice<Slice>), py::arg("plane"), py::call_guard<py::gil_scoped_release>(), DOC(Domain, get_slice))
+        .def("get_slice", py::overload_cast<double, double, double, double>(&Domain::get_slice<Slice>), py::arg("a"), py::arg("b"), py::arg("c"), py::arg("d"),
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, get_slice, 2))
+        .def("check_surfaces", &Domain::check_surfaces, py::arg("num_threads") = 0, py::call_guard<py::gil_scoped_release>(), DOC(Domain, check_surfaces))
+        .def("get_slices", &Domain::get_slices<Slice>, py::arg("planes"), py::arg("num_threads") = 0, py::call_guard<py::gil_scoped_release>(), DOC(Domain, get_slices))
+        .def("refine", interruptible(&Domain::refine), py::arg("levels") = 1, py::arg("subdomains") = std::vector<int>(), py::arg("num_threads") = 0, DOC(Domain, refine))
+
+        .def("radius_ratios_min_max", &Domain::radius_ratios_min_max, py::call_guard<py::gil_scoped_release>(), DOC(Domain, radius_ratios_min_max))
+        .def("dihedral_angles_min_max", &Domain::dihedral_angles_min_max, py::call_guard<py::gil_scoped_release>(), DOC(Domain, dihedral_angles_min_max))
+
+        .def("radius_ratios", &Domain::radius_ratios, py::call_guard<py::gil_scoped_release>(), DOC(Domain, radius_ratios))
+        .def("dihedral_angles", &Domain::dihedral_angles, py::call_guard<py::gil_scoped_release>(), DOC(Domain, dihedral_angles))
+
+        .def("get_boundary", &Domain::get_boundary<Surface>, py::arg("tag") = 0, py::call_guard<py::gil_scoped_release>(), DOC(Domain, get_boundary))
+        .def("get_boundaries", &Domain::get_boundaries<Surface>, py::call_guard<py::gil_scoped_release>(), DOC(Domain, get_boundaries))
+
+        .def("get_borders", &Domain::get_borders, DOC(Domain, get_borders))
+        .def("get_interface", &Domain::get_interface<Surface>, py::call_guard<py::gil_scoped_release>()) //, DOC(Domain,get_interface))
         .def("get_curve_tags", &Domain::get_curve_tags, DOC(Domain, get_curve_tags))
         .def("get_patches", &Domain::get_patches, DOC(Domain, get_patches))
         .def("get_subdomains", &Domain::get_subdomains, DOC(Domain, get_subdomains))
-        .def("check_mesh_connections", &Domain::check_mesh_connections, DOC(Domain, check_mesh_connections))
-        .def("lloyd", &Domain::lloyd, py::arg("time_limit") = 0,
+        .def("check_mesh_connections", &Domain::check_mesh_connections, py::call_guard<py::gil_scoped_release>(), DOC(Domain, check_mesh_connections))
+        .def("lloyd", interruptible(&Domain::lloyd), py::arg("time_limit") = 0,
              py::arg("max_iter") = 0,
              py::arg("convergence") = 0.02,
              py::arg("freeze_bound") = 0.01,
              py::arg("do_freeze") = true, DOC(Domain, lloyd))
 
-        .def("odt", &Domain::odt, py::arg("time_limit") = 0,
+        .def("odt", interruptible(&Domain::odt), py::arg("time_limit") = 0,
              py::arg("max_iter") = 0,
              py::arg("convergence") = 0.02,
              py::arg("freeze_bound") = 0.01,
              py::arg("do_freeze") = true, DOC(Domain, odt))
 
-        .def("exude", &Domain::exude, py::arg("time_limit") = 0, py::arg("sliver_bound") = 0, DOC(Domain, exude))
-        .def("perturb", &Domain::perturb, py::arg("time_limit") = 0, py::arg("sliver_bound") = 0, DOC(Domain, perturb))
+        .def("exude", interruptible(&Domain::exude), py::arg("time_limit") = 0, py::arg("sliver_bound") = 0, DOC(Domain, exude))
+        .def("perturb", interruptible(&Domain::perturb), py::arg("time_limit") = 0, py::arg("sliver_bound") = 0, DOC(Domain, perturb))
+        .def("optimize", interruptible(&Domain::optimize), py::arg("min_dihedral_angle") = 10., py::arg("min_radius_ratio") = 0.1,
+             py::arg("time_budget") = 60., DOC(Domain, optimize))
 
         // TODO add sharp border edges multiple surfaces
         .def("add_sharp_border_edges", py::overload_cast<Surface &, double>(&Domain::add_sharp_border_edges<Surface>), py::arg("surface"),
              py::arg("threshold") = 60,
-             DOC(Domain, add_sharp_border_edges))
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, add_sharp_border_edges))
         .def("add_sharp_border_edges", py::overload_cast<Surface &, Plane_3, double>(&Domain::add_sharp_border_edges<Surface, Plane_3>), py::arg("surface"),
              py::arg("plane"),
              py::arg("threshold") = 60,
-             DOC(Domain, add_sharp_border_edges, 2))
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, add_sharp_border_edges, 2))
         .def("clear_borders", &Domain::clear_borders, DOC(Domain, clear_borders))
         .def("clear_features", &Domain::clear_features, DOC(Domain, clear_features))
 
-        .def("remove_subdomain", py::overload_cast<std::vector<int>>(&Domain::remove_subdomain), DOC(Domain, remove_subdomain))
-        .def("remove_subdomain", py::overload_cast<int>(&Domain::remove_subdomain), DOC(Domain, remove_subdomain, 2))
+        .def("remove_subdomain", py::overload_cast<std::vector<int>>(&Domain::remove_subdomain), py::call_guard<py::gil_scoped_release>(), DOC(Domain, remove_subdomain))
+        .def("remove_subdomain", py::overload_cast<int>(&Domain::remove_subdomain), py::call_guard<py::gil_scoped_release>(), DOC(Domain, remove_subdomain, 2))
+        .def("relabel_subdomains", py::overload_cast<std::map<int,int>>(&Domain::relabel_subdomains), py::arg("tags"),
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, relabel_subdomains))
+        .def("relabel_subdomains", &Domain::relabel_subdomains<Surface>, py::arg("surfaces"), py::arg("map"), py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, relabel_subdomains, 2))
 
         .def("number_of_cells", &Domain::number_of_cells, DOC(Domain, number_of_cells))
         .def("number_of_subdomains", &Domain::number_of_subdomains, DOC(Domain, number_of_subdomains))
@@ -405,34 +644,144 @@ PYBIND11_MODULE(SVMTK, m)
         .def("number_of_surfaces", &Domain::number_of_surfaces, DOC(Domain, number_of_surfaces))
         .def("number_of_facets", &Domain::number_of_facets, DOC(Domain, number_of_facets))
         .def("number_of_vertices", &Domain::number_of_vertices, DOC(Domain, number_of_vertices))
+        .def("get_counters", &Domain::get_counters, DOC(Domain, get_counters))
+        .def("reset_counters", &Domain::reset_counters, DOC(Domain, reset_counters))
+        .def("memory_report", &Domain::memory_report, DOC(Domain, memory_report))
+        .def("finalize", &Domain::finalize, DOC(Domain, finalize))
+        .def("is_completed", &Domain::is_completed, DOC(Domain, is_completed))
+        .def("is_finalized", &Domain::is_finalized, DOC(Domain, is_finalized))
+        .def("is_regular", &Domain::is_regular, DOC(Domain, is_regular))
+        .def("set_verbose", &Domain::set_verbose, py::arg("value"), DOC(Domain, set_verbose))
 
         // .def("subdomain_reduction", &Domain::subdomain_reduction<Surface>)
 
         .def("boundary_segmentations", py::overload_cast<std::pair<int, int>, double>(&Domain::boundary_segmentations<Surface>),
              py::arg("interface"),
              py::arg("angle_in_degree") = 85,
-             DOC(Domain, boundary_segmentations))
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, boundary_segmentations))
 
         .def("boundary_segmentations", py::overload_cast<int, double>(&Domain::boundary_segmentations<Surface>),
              py::arg("subdomain_tag"),
              py::arg("angle_in_degree") = 85,
-             DOC(Domain, boundary_segmentations, 2))
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, boundary_segmentations, 2))
 
         .def("boundary_segmentations", py::overload_cast<double>(&Domain::boundary_segmentations<Surface>),
              py::arg("angle_in_degree") = 85,
-             DOC(Domain, boundary_segmentations, 3))
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, boundary_segmentations, 3))
 
         .def("add_feature", &Domain::add_feature, DOC(Domain, add_feature))
+        .def("set_region_of_interest", py::overload_cast<double, double, double, double, double, double>(&Domain::set_region_of_interest), py::arg("xmin"), py::arg("ymin"), py::arg("zmin"),
+             py::arg("xmax"), py::arg("ymax"), py::arg("zmax"), DOC(Domain, set_region_of_interest))
+        .def("set_region_of_interest", py::overload_cast<double, double, double, double>(&Domain::set_region_of_interest), py::arg("x"), py::arg("y"), py::arg("z"), py::arg("radius"),
+             DOC(Domain, set_region_of_interest, 2))
+        .def("set_region_of_interest", &Domain::set_region_of_interest<Surface>, py::arg("surface"), DOC(Domain, set_region_of_interest, 3))
+        .def("clear_region_of_interest", &Domain::clear_region_of_interest, DOC(Domain, clear_region_of_interest))
+        .def("add_intersection_features", &Domain::add_intersection_features, py::arg("num_threads") = 0, py::call_guard<py::gil_scoped_release>(), DOC(Domain, add_intersection_features))
         .def("add_border", &Domain::add_border, DOC(Domain, add_border))
+        .def("set_output_ordering", &Domain::set_output_ordering, py::arg("ordering"), DOC(Domain, set_output_ordering))
+        .def("get_output_ordering", &Domain::get_output_ordering, DOC(Domain, get_output_ordering))
+        .def("set_data", &Wrapper_set_data, py::arg("name"), py::arg("entity"), py::arg("values"), DOC(Domain, set_data))
+        .def("get_data", &Wrapper_get_data, py::arg("name"), DOC(Domain, get_data))
+        .def("get_data_entity", &Domain::get_data_entity, py::arg("name"), DOC(Domain, get_data_entity))
+        .def("get_data_names", &Domain::get_data_names, DOC(Domain, get_data_names))
+        .def("remove_data", &Domain::remove_data, py::arg("name"), DOC(Domain, remove_data))
+        .def("number_of_data_entities", &Domain::number_of_data_entities, py::arg("entity"), DOC(Domain, number_of_data_entities))
+        .def("write_facet_data", &Domain::write_facet_data, py::arg("filename"), py::arg("name") = "collision_distance",
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, write_facet_data))
+        .def("save_xdmf", &Domain::save_xdmf, py::arg("outpath"), py::call_guard<py::gil_scoped_release>(), DOC(Domain, save_xdmf))
+        .def("partition", &Domain::partition, py::arg("num_parts"), py::arg("imbalance") = 1.03, py::call_guard<py::gil_scoped_release>(), DOC(Domain, partition))
+        .def("save_partitions", &Domain::save_partitions, py::arg("outpath"), py::arg("ghost_layers") = 0, py::arg("save_1Dfeatures") = true,
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, save_partitions))
         .def("save", py::overload_cast<std::string, bool>(&Domain::save),
              py::arg("OutPath"),
              py::arg("save_1Dfeatures") = true,
-             DOC(Domain, save));
-
-    m.def("load_points", &Wrapper_load_points); // TODO
+             py::call_guard<py::gil_scoped_release>(), DOC(Domain, save));
+
+    py::class_<MeshingJob<Surface>, std::shared_ptr<MeshingJob<Surface>>>(m, "MeshingJob", DOC(MeshingJob))
+        .def(py::init<>())
+        .def(py::init([](std::vector<Surface> surfaces, std::shared_ptr<AbstractMap> map, double mesh_resolution,
+                         std::vector<std::string> post_processing, std::string output, double error_bound)
+                      {
+                          auto job = std::make_shared<MeshingJob<Surface>>();
+                          job->surfaces = surfaces;
+                          job->map = map;
+                          job->mesh_resolution = mesh_resolution;
+                          job->post_processing = post_processing;
+                          job->output = output;
+                          job->error_bound = error_bound;
+                          return job; }),
+             py::arg("surfaces"), py::arg("map") = py::none(), py::arg("mesh_resolution") = 0, py::arg("post_processing") = std::vector<std::string>(),
+             py::arg("output") = "", py::arg("error_bound") = 1.e-7, DOC(MeshingJob, MeshingJob))
+        .def_readwrite("surfaces", &MeshingJob<Surface>::surfaces)
+        .def_readwrite("map", &MeshingJob<Surface>::map)
+        .def_readwrite("mesh_resolution", &MeshingJob<Surface>::mesh_resolution)
+        .def_readwrite("error_bound", &MeshingJob<Surface>::error_bound)
+        .def_readwrite("post_processing", &MeshingJob<Surface>::post_processing)
+        .def_readwrite("output", &MeshingJob<Surface>::output)
+        .def_readwrite("save_1Dfeatures", &MeshingJob<Surface>::save_1Dfeatures)
+        .def_readwrite("memory_estimate", &MeshingJob<Surface>::memory_estimate);
+
+    py::class_<MeshingResult, std::shared_ptr<MeshingResult>>(m, "MeshingResult", DOC(MeshingResult))
+        .def_readonly("completed", &MeshingResult::completed)
+        .def_readonly("number_of_cells", &MeshingResult::number_of_cells)
+        .def_readonly("seconds", &MeshingResult::seconds)
+        .def_readonly("memory", &MeshingResult::memory)
+        .def_readonly("error", &MeshingResult::error)
+        .def("__repr__", [](const MeshingResult &self)
+             { return "MeshingResult(completed=" + std::string(self.completed ? "True" : "False") +
+                      ", number_of_cells=" + std::to_string(self.number_of_cells) +
+                      ", seconds=" + std::to_string(self.seconds) + ", error='" + self.error + "')"; });
+
+    py::class_<OptimizationPass, std::shared_ptr<OptimizationPass>>(m, "OptimizationPass", DOC(OptimizationPass))
+        .def_readonly("optimizer", &OptimizationPass::optimizer)
+        .def_readonly("time_limit", &OptimizationPass::time_limit)
+        .def_readonly("seconds", &OptimizationPass::seconds)
+        .def_readonly("min_dihedral_angle_before", &OptimizationPass::min_dihedral_angle_before)
+        .def_readonly("min_dihedral_angle_after", &OptimizationPass::min_dihedral_angle_after)
+        .def_readonly("min_radius_ratio_before", &OptimizationPass::min_radius_ratio_before)
+        .def_readonly("min_radius_ratio_after", &OptimizationPass::min_radius_ratio_after)
+        .def_readonly("completed", &OptimizationPass::completed)
+        .def("__repr__", [](const OptimizationPass &self)
+             { return "OptimizationPass(optimizer='" + self.optimizer + "', seconds=" + std::to_string(self.seconds) +
+                      ", min_dihedral_angle=" + std::to_string(self.min_dihedral_angle_before) + "->" + std::to_string(self.min_dihedral_angle_after) +
+                      ", min_radius_ratio=" + std::to_string(self.min_radius_ratio_before) + "->" + std::to_string(self.min_radius_ratio_after) + ")"; });
+
+    py::class_<SurfaceClash, std::shared_ptr<SurfaceClash>>(m, "SurfaceClash", DOC(SurfaceClash))
+        .def_readonly("first", &SurfaceClash::first)
+        .def_readonly("second", &SurfaceClash::second)
+        .def_readonly("type", &SurfaceClash::type)
+        .def_readonly("count", &SurfaceClash::count)
+        .def_readonly("location", &SurfaceClash::location)
+        .def("__repr__", [](const SurfaceClash &self)
+             { return "SurfaceClash(type='" + self.type + "', first=" + std::to_string(self.first) + ", second=" + std::to_string(self.second) +
+                      ", count=" + std::to_string(self.count) + ")"; });
+
+    py::class_<BatchMesher<Surface>, std::shared_ptr<BatchMesher<Surface>>>(m, "BatchMesher", DOC(BatchMesher))
+        .def(py::init<int, std::size_t>(), py::arg("num_threads") = 0, py::arg("memory_limit") = 0, DOC(BatchMesher, BatchMesher))
+        .def("run", interruptible(&BatchMesher<Surface>::run), py::arg("jobs"), DOC(BatchMesher, run))
+        .def("get_bytes_per_face", &BatchMesher<Surface>::get_bytes_per_face, DOC(BatchMesher, get_bytes_per_face));
+
+    py::class_<Workload<Surface>, std::shared_ptr<Workload<Surface>>>(m, "Workload", DOC(Workload))
+        .def_readonly("name", &Workload<Surface>::name)
+        .def_readonly("surfaces", &Workload<Surface>::surfaces)
+        .def_readonly("map", &Workload<Surface>::map)
+        .def_readonly("edge_length", &Workload<Surface>::edge_length)
+        .def("number_of_triangles", &Workload<Surface>::number_of_triangles, DOC(Workload, number_of_triangles));
+
+    m.def("make_workload", &make_workload<Surface>, py::arg("scene"), py::arg("number_of_surfaces"), py::arg("number_of_triangles"),
+          py::arg("seed") = 0, py::call_guard<py::gil_scoped_release>(), DOC(make_workload));
+
+    m.def("enable_timings", [](bool enable) { PhaseTimings::instance().enable(enable); },
+          py::arg("enable") = true, DOC(enable_timings));
+    m.def("clear_timings", []() { PhaseTimings::instance().clear(); }, DOC(clear_timings));
+    m.def("get_timings", []() { return PhaseTimings::instance().get_timings(); }, DOC(get_timings));
+    m.def("write_chrome_trace", [](std::string filename) { PhaseTimings::instance().write_chrome_trace(filename); },
+          py::arg("filename"), DOC(write_chrome_trace));
+
+    m.def("load_points", &Wrapper_load_points, py::call_guard<py::gil_scoped_release>()); // TODO
     m.def("convex_hull", &Wrapper_convex_hull); // TODO
 
-    m.def("separate_overlapping_surfaces", py::overload_cast<Surface &, Surface &, Surface &, double, double, int>(&separate_surface_overlapp<Surface>),
+    m.def("separate_overlapping_surfaces", interruptible(py::overload_cast<Surface &, Surface &, Surface &, double, double, int>(&separate_surface_overlapp<Surface>)),
           py::arg("surf1"),
           py::arg("surf2"),
           py::arg("other"),
@@ -441,7 +790,7 @@ PYBIND11_MODULE(SVMTK, m)
           py::arg("max_iter") = 400,
           DOC(separate_surface_overlapp));
 
-    m.def("separate_overlapping_surfaces", py::overload_cast<Surface &, Surface &, double, double, int>(&separate_surface_overlapp<Surface>),
+    m.def("separate_overlapping_surfaces", interruptible(py::overload_cast<Surface &, Surface &, double, double, int>(&separate_surface_overlapp<Surface>)),
           py::arg("surf1"),
           py::arg("surf2"),
           py::arg("edge_movement") = -0.5,
@@ -449,7 +798,7 @@ PYBIND11_MODULE(SVMTK, m)
           py::arg("max_iter") = 400,
           DOC(separate_surface_overlapp, 2));
 
-    m.def("separate_close_surfaces", py::overload_cast<Surface &, Surface &, Surface &, double, double, int>(&separate_close_surfaces<Surface>),
+    m.def("separate_close_surfaces", interruptible(py::overload_cast<Surface &, Surface &, Surface &, double, double, int>(&separate_close_surfaces<Surface>)),
           py::arg("surf1"),
           py::arg("surf2"),
           py::arg("other"),
@@ -458,7 +807,7 @@ PYBIND11_MODULE(SVMTK, m)
           py::arg("max_iter") = 400,
           DOC(separate_close_surfaces));
 
-    m.def("separate_close_surfaces", py::overload_cast<Surface &, Surface &, double, double, int>(&separate_close_surfaces<Surface>),
+    m.def("separate_close_surfaces", interruptible(py::overload_cast<Surface &, Surface &, double, double, int>(&separate_close_surfaces<Surface>)),
           py::arg("surf1"),
           py::arg("surf2"),
           py::arg("edge_movement") = -0.5,
@@ -466,7 +815,7 @@ PYBIND11_MODULE(SVMTK, m)
           py::arg("max_iter") = 400,
           DOC(separate_close_surfaces, 2));
 
-    m.def("union_partially_overlapping_surfaces", &union_partially_overlapping_surfaces<Surface>,
+    m.def("union_partially_overlapping_surfaces", interruptible(&union_partially_overlapping_surfaces<Surface>),
           py::arg("surf1"),
           py::arg("surf2"),
           py::arg("angle_in_degress") = 36.87,
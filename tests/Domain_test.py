@@ -1,8 +1,29 @@
 
 import unittest
+import os
 import SVMTK
 
 
+def read_medit(filename):
+    """Returns the vertex coordinates and the tetrahedra with 0-based vertex numbers of a medit file."""
+    with open(filename) as f:
+        lines = [line.split() for line in f]
+    vertices, tetrahedra = [], []
+    i = 0
+    while i < len(lines):
+        if lines[i] and lines[i][0] in ("Vertices","Tetrahedra"):
+            section, size = lines[i][0], int(lines[i+1][0])
+            for line in lines[i+2:i+2+size]:
+                if section=="Vertices":
+                    vertices.append(tuple(float(x) for x in line[:3]))
+                else:
+                    tetrahedra.append([int(x)-1 for x in line[:4]])
+            i += 2 + size
+        else:
+            i += 1
+    return vertices, tetrahedra
+
+
 class Domain_Test(unittest.TestCase):
 
     def test_single_domain(self):
@@ -74,6 +95,27 @@ class Domain_Test(unittest.TestCase):
         domain.add_sharp_border_edges(surface)
         domain.create_mesh(1.)
         self.assertTrue(domain.number_of_curves() > 0) 
+        curves = domain.get_curve_tags()
+        domain.create_mesh(1.)
+        self.assertEqual(domain.get_curve_tags(),curves)
+
+    def test_sharp_border_edges_in_plane(self):
+        for z in (0.,1.):
+            surface = SVMTK.Surface()
+            surface.make_cube(0.,0.,0.,1.,1.,1.,1)
+            domain = SVMTK.Domain(surface)
+            domain.add_sharp_border_edges(surface,SVMTK.Plane_3(0.,0.,1.,-z),60)
+            self.assertTrue(len(domain.get_borders())>0)
+            for polyline in domain.get_borders():
+                for point in polyline:
+                    self.assertAlmostEqual(point.z(),z)
+
+        # The edges in the plane x=0 that touch the borders in the plane z=1 are rejected.
+        domain.add_sharp_border_edges(surface,SVMTK.Plane_3(1.,0.,0.,0.),60)
+        points = [point for polyline in domain.get_borders() for point in polyline]
+        self.assertTrue(any(abs(point.x())<1.e-8 and abs(point.z())<1.e-8 for point in points))
+        for point in points:
+            self.assertTrue(abs(point.z()-1.)<1.e-8 or ( abs(point.x())<1.e-8 and abs(point.z())<1.e-8 ))
 
     def test_mesh_lloyd(self):
         surface_1 = SVMTK.Surface() 
@@ -131,6 +173,381 @@ class Domain_Test(unittest.TestCase):
 
         self.assertTrue(domain.number_of_patches()==9)       
         
+    def test_query_counters(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,1) 
+        surface_2 = SVMTK.Surface() 
+        surface_2.make_cube(-2.,-2.,-2.,2.,2.,2.,1)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        self.assertEqual(domain.get_counters()["aabb_tree_constructions"],2)
+        domain.create_mesh(1.)
+        counters = domain.get_counters()
+        self.assertTrue(counters["labeling_calls"]>0)
+        self.assertEqual(counters["is_in_domain_evaluations"],2*counters["labeling_calls"])
+        domain.reset_counters()
+        self.assertEqual(domain.get_counters()["labeling_calls"],0)
+        
+    def test_cancellation_token(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,1) 
+        domain = SVMTK.Domain(surface_1)
+        token = SVMTK.CancellationToken()
+        token.cancel()
+        with token:
+            self.assertFalse(domain.create_mesh(1.))
+        self.assertTrue(domain.create_mesh(1.))
+        with SVMTK.CancellationToken(3600.) as token:
+            self.assertTrue(token.remaining_time()>0)
+            self.assertTrue(domain.create_mesh(1.))
+        cancelled = SVMTK.CancellationToken()
+        cancelled.cancel()
+        with cancelled:
+            with SVMTK.CancellationToken():
+                self.assertTrue(domain.create_mesh(1.))
+            self.assertFalse(domain.create_mesh(1.))
+        self.assertTrue(domain.create_mesh(1.))
+
+    def test_finalize(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,1) 
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(1.)
+        report = domain.memory_report()
+        self.assertTrue(report["polyhedral_domains"]>0)
+        self.assertTrue(report["triangulation"]>0)
+        domain.finalize()
+        self.assertTrue(domain.is_finalized())
+        self.assertEqual(domain.memory_report()["polyhedral_domains"],0)
+        self.assertTrue(domain.memory_report()["total"]<report["total"])
+        self.assertEqual(domain.number_of_surfaces(),1)
+        self.assertTrue(domain.number_of_cells()>0)
+        with self.assertRaises(SVMTK.PreconditionError):
+            domain.create_mesh(1.)
+
+    def test_batch_mesher(self):
+        jobs = []
+        for i in range(3):
+            surface = SVMTK.Surface()
+            surface.make_cube(-1.-i,-1.,-1.,1.,1.,1.,1)
+            jobs.append(SVMTK.MeshingJob([surface], mesh_resolution=1., post_processing=["exude"]))
+        results = SVMTK.BatchMesher(num_threads=2).run(jobs)
+        self.assertEqual(len(results),3)
+        for result in results:
+            self.assertTrue(result.completed)
+            self.assertTrue(result.number_of_cells>0)
+            self.assertEqual(result.error,"")
+        jobs[0].post_processing = ["unknown"]
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            SVMTK.BatchMesher().run(jobs)
+
+    def test_create_mesh_sweep(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,1) 
+        domain = SVMTK.Domain(surface_1)
+        meshes = domain.create_mesh_sweep([1.,2.,4.])
+        self.assertEqual(len(meshes),3)
+        self.assertTrue(meshes[0].number_of_cells()<meshes[2].number_of_cells())
+        self.assertTrue(meshes[1].is_finalized())
+        self.assertEqual(domain.number_of_cells(),0)
+        self.assertTrue(all(mesh.is_completed() for mesh in meshes))
+        token = SVMTK.CancellationToken()
+        token.cancel()
+        with token:
+            meshes = domain.create_mesh_sweep([1.,2.],2)
+        self.assertFalse(any(mesh.is_completed() for mesh in meshes))
+
+    def test_create_mesh_sweep_with_borders(self):
+        surface = SVMTK.Surface() 
+        surface.make_cube(0.,0.,0.,1.,1.,1.,1) 
+        domain = SVMTK.Domain(surface)
+        domain.add_sharp_border_edges(surface)
+        domain.create_mesh(2.)
+        meshes = domain.create_mesh_sweep([2.,2.,2.],3)
+        for mesh in meshes:
+            self.assertEqual(mesh.get_curve_tags(),domain.get_curve_tags())
+            self.assertEqual(mesh.number_of_curves(),meshes[0].number_of_curves())
+            self.assertTrue(mesh.number_of_curves()>0)
+
+    def test_create_mesh_clusters(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_sphere(-3.,0.,0.,1.,0.5) 
+        surface_2 = SVMTK.Surface() 
+        surface_2.make_sphere(3.,0.,0.,1.,0.5) 
+        surface_3 = SVMTK.Surface() 
+        surface_3.make_sphere(3.,0.,0.,0.5,0.5) 
+        domain = SVMTK.Domain([surface_1,surface_2,surface_3])
+        self.assertTrue(domain.create_mesh_clusters(8.,2))
+        self.assertTrue(domain.number_of_cells()>0)
+        self.assertEqual(domain.get_subdomains(),{1,2,6})
+        self.assertEqual(domain.number_of_curves(),0)
+
+    def test_partition(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,1) 
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(4.)
+        parts = domain.partition(4)
+        self.assertEqual(len(parts),domain.number_of_cells())
+        self.assertEqual(set(parts),{0,1,2,3})
+        domain.save_partitions("tests/Data/partition.mesh",1)
+        for part in range(4):
+            self.assertTrue(os.path.isfile("tests/Data/partition_%d.mesh"%part))
+            self.assertTrue(os.path.isfile("tests/Data/partition_%d.map"%part))
+            os.remove("tests/Data/partition_%d.mesh"%part)
+            os.remove("tests/Data/partition_%d.map"%part)
+
+    def test_output_ordering(self):
+        surface_1 = SVMTK.Surface() 
+        surface_1.make_sphere(0.,0.,0.,1.,0.2) 
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(8.)
+        self.assertEqual(domain.get_output_ordering(),"none")
+        def read_ordering():
+            domain.save("tests/Data/ordering.mesh")
+            vertices, tetrahedra = read_medit("tests/Data/ordering.mesh")
+            os.remove("tests/Data/ordering.mesh")
+            cells = sorted(tuple(sorted(vertices[i] for i in t)) for t in tetrahedra)
+            spreads = [max(t)-min(t) for t in tetrahedra]
+            return vertices, cells, max(spreads), sum(spreads)/len(spreads)
+        vertices, cells, bandwidth, spread = read_ordering()
+        for ordering in ["hilbert","rcm"]:
+            domain.set_output_ordering(ordering)
+            ordered_vertices, ordered_cells, ordered_bandwidth, ordered_spread = read_ordering()
+            self.assertEqual(sorted(ordered_vertices),sorted(vertices))
+            self.assertEqual(ordered_cells,cells)
+            self.assertTrue(ordered_spread<spread)
+            if ordering=="rcm":
+                self.assertTrue(ordered_bandwidth<bandwidth)
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.set_output_ordering("morton")
+
+    def test_data_fields(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_cube(-0.5,-0.5,-0.5,0.5,0.5,0.5,0.5)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        domain.create_mesh(8.)
+        cells = domain.number_of_data_entities("cell")
+        domain.set_data("index","cell",[float(i) for i in range(cells)])
+        domain.set_data("position","vertex",[[0.,0.,0.]]*domain.number_of_data_entities("vertex"))
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.set_data("index","facet",[0.])
+        domain.remove_subdomain(2)
+        self.assertEqual(len(domain.get_data("index")),domain.number_of_cells())
+        self.assertTrue(len(domain.get_data("index"))<cells)
+        self.assertEqual(domain.get_data("position").shape[1],3)
+        domain.save_xdmf("tests/Data/data.xdmf")
+        self.assertTrue(os.path.isfile("tests/Data/data.xdmf"))
+        self.assertTrue(os.path.isfile("tests/Data/data.bin"))
+        os.remove("tests/Data/data.xdmf")
+        os.remove("tests/Data/data.bin")
+        domain.remove_data("index")
+        self.assertEqual(domain.get_data_names(),["position"])
+
+    def test_relabel_subdomains(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_cube(-0.5,-0.5,-0.5,0.5,0.5,0.5,0.5)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        domain.create_mesh(8.)
+        cells = domain.number_of_cells()
+        self.assertEqual(domain.number_of_subdomains(),2)
+        self.assertTrue(domain.relabel_subdomains({3:1})>0)
+        self.assertEqual(domain.number_of_subdomains(),1)
+        self.assertEqual(domain.number_of_cells(),cells)
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.relabel_subdomains({1:0})
+        smap = SVMTK.SubdomainMap()
+        smap.add("1",5)
+        self.assertTrue(domain.relabel_subdomains([surface_2],smap,2)>0)
+        self.assertEqual(domain.number_of_subdomains(),2)
+
+    def test_optimize(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_sphere(0.,0.,0.,1.,0.4)
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(8.)
+        self.assertEqual(len(domain.optimize(0.,0.,10.)),0)
+        passes = domain.optimize(90.,1.,10.)
+        self.assertTrue(len(passes)>0)
+        self.assertEqual(passes[-1].optimizer,"exude")
+        self.assertEqual(passes[0].min_dihedral_angle_after,passes[1].min_dihedral_angle_before)
+
+    def test_refine(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_cube(-0.5,-0.5,-0.5,0.5,0.5,0.5,0.5)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        domain.create_mesh(8.)
+        refined = domain.refine(1,[],2)
+        self.assertEqual(refined.number_of_cells(),8*domain.number_of_cells())
+        self.assertEqual(refined.get_subdomains(),domain.get_subdomains())
+        self.assertEqual(refined.get_patches(),domain.get_patches())
+        self.assertEqual(refined.get_curve_tags(),domain.get_curve_tags())
+        self.assertTrue(domain.is_regular())
+        self.assertFalse(refined.is_regular())
+        with self.assertRaises(SVMTK.PreconditionError):
+            refined.exude()
+        with self.assertRaises(SVMTK.PreconditionError):
+            refined.remove_subdomain(2)
+        self.assertTrue(all(p.optimizer!="exude" for p in refined.optimize(90.,1.,10.)))
+        partial = domain.refine(1,[3])
+        self.assertTrue(partial.number_of_cells()>domain.number_of_cells())
+        self.assertTrue(partial.number_of_cells()<refined.number_of_cells())
+        refined.save("tests/Data/refined.mesh")
+        self.assertTrue(os.path.isfile("tests/Data/refined.mesh"))
+        os.remove("tests/Data/refined.mesh")
+
+    def test_remesh_subdomains(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_sphere(0.,0.,0.,0.5,0.2)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        domain.create_mesh(8.)
+        surface_3 = SVMTK.Surface()
+        surface_3.make_sphere(0.,0.,0.,0.6,0.2)
+        self.assertTrue(domain.remesh_subdomains([surface_1,surface_3],[3],1,8.))
+        self.assertEqual(domain.get_subdomains(),{1,3})
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.remesh_subdomains([surface_1],[3])
+
+    def test_morph(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_sphere(0.,0.,0.,1.,0.3)
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(8.)
+        cells = domain.number_of_cells()
+        surface_2 = SVMTK.Surface(surface_1)
+        surface_2.adjust_boundary(0.1)
+        self.assertEqual(domain.morph([surface_2]),0)
+        self.assertEqual(domain.number_of_cells(),cells)
+        self.assertTrue(domain.is_finalized())
+        self.assertFalse(domain.is_regular())
+        with self.assertRaises(SVMTK.PreconditionError):
+            domain.exude()
+        with self.assertRaises(SVMTK.PreconditionError):
+            domain.remove_subdomain(1)
+        self.assertEqual(domain.morph([surface_1]),0)
+        self.assertEqual(domain.number_of_cells(),cells)
+        surface_3 = SVMTK.Surface()
+        surface_3.make_sphere(0.,0.,0.,1.,0.2)
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.morph([surface_3])
+
+    def test_morph_remesh(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_sphere(0.,0.,0.,1.,0.3)
+        domain = SVMTK.Domain(surface_1)
+        domain.create_mesh(8.)
+        surface_2 = SVMTK.Surface(surface_1)
+        surface_2.adjust_boundary(0.3)
+        self.assertTrue(domain.morph([surface_2],30.)>0)
+        self.assertFalse(domain.is_finalized())
+        self.assertTrue(domain.is_regular())
+        self.assertEqual(domain.get_subdomains(),{1})
+        for point in domain.get_boundary(1).get_points():
+            radius = (point.x()**2 + point.y()**2 + point.z()**2)**0.5
+            self.assertTrue(1.15 < radius < 1.35)
+
+    def test_check_surfaces(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_sphere(0.,0.,0.,0.5,0.2)
+        smap = SVMTK.SubdomainMap(2)
+        smap.add("10",1)
+        smap.add("11",2)
+        domain = SVMTK.Domain([surface_1,surface_2],smap,1.e-7,True)
+        self.assertEqual(len(domain.check_surfaces()),0)
+        surface_3 = SVMTK.Surface()
+        surface_3.make_sphere(1.,0.,0.,0.5,0.2)
+        clashes = SVMTK.Domain([surface_1,surface_3]).check_surfaces()
+        self.assertEqual(len(clashes),1)
+        self.assertEqual(clashes[0].type,"intersection")
+        surface_4 = SVMTK.Surface()
+        surface_4.make_sphere(3.,0.,0.,0.5,0.2)
+        clashes = SVMTK.Domain([surface_1,surface_4],smap).check_surfaces()
+        self.assertEqual([clash.type for clash in clashes],["nesting"])
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            SVMTK.Domain([surface_1,surface_3],smap,1.e-7,True)
+
+    def test_region_of_interest(self):
+        surface = SVMTK.Surface()
+        surface.make_sphere(0.,0.,0.,1.,0.2)
+        domain = SVMTK.Domain(surface)
+        domain.create_mesh(8.)
+        cells = domain.number_of_cells()
+        self.assertEqual(domain.number_of_curves(),0)
+        domain.set_region_of_interest(0.,-1.,-1.,1.,1.,1.)
+        domain.create_mesh(8.)
+        self.assertTrue(domain.number_of_cells()<cells)
+        self.assertEqual(domain.number_of_patches(),2)
+        self.assertTrue(domain.number_of_curves()>0)
+        domain.set_region_of_interest(0.,0.,0.,0.5)
+        domain.create_mesh(8.)
+        self.assertTrue(domain.number_of_cells()>0)
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            domain.set_region_of_interest(5.,5.,5.,0.5)
+        domain.clear_region_of_interest()
+        domain.create_mesh(8.)
+        self.assertEqual(domain.number_of_curves(),0)
+
+    def test_intersection_features(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_sphere(0.,0.,0.,1.,0.3)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_sphere(1.,0.,0.,1.,0.3)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        self.assertTrue(domain.add_intersection_features()>0)
+        self.assertTrue(domain.create_mesh(8.))
+        self.assertEqual(domain.get_subdomains(),{1,2,3})
+
+    def test_domain_slice(self):
+        surface_1 = SVMTK.Surface()
+        surface_1.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        surface_2 = SVMTK.Surface()
+        surface_2.make_sphere(0.,0.,0.,0.5,0.2)
+        domain = SVMTK.Domain([surface_1,surface_2])
+        domain.create_mesh(8.)
+        slice_ = domain.get_slice(0.,0.,1.,0.)
+        self.assertEqual(slice_.get_subdomains(),domain.get_subdomains())
+        self.assertTrue(slice_.number_of_faces()>0)
+        slices = domain.get_slices([SVMTK.Plane_3(0.,0.,1.,z) for z in (-0.5,0.,0.5)],2)
+        self.assertEqual(len(slices),3)
+        slices[1].save("tests/Data/domain_slice.mesh")
+        self.assertTrue(os.path.isfile("tests/Data/domain_slice.mesh"))
+        os.remove("tests/Data/domain_slice.mesh")
+
+    def test_domain_slice_facets(self):
+        surface = SVMTK.Surface()
+        surface.make_cube(-1.,-1.,-1.,1.,1.,1.,0.5)
+        domain = SVMTK.Domain(surface)
+        domain.create_mesh(8.)
+        slice_ = domain.get_slice(0.,0.,1.,0.)
+        self.assertEqual(slice_.get_subdomains(),{1})
+        self.assertAlmostEqual(slice_.export_as_surface().area(),4.,places=3)
+        bottom = domain.get_slice(0.,0.,1.,1.)
+        self.assertAlmostEqual(bottom.export_as_surface().area(),4.,places=3)
+
+    def test_threaded_meshing(self):
+        import threading
+        domains = []
+        for i in range(2):
+            surface = SVMTK.Surface()
+            surface.make_sphere(0.,0.,0.,1.+i,0.4)
+            domains.append(SVMTK.Domain(surface))
+        threads = [threading.Thread(target=domain.create_mesh, args=(8.,)) for domain in domains]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        for domain in domains:
+            self.assertTrue(domain.number_of_cells()>0)
+        
 
 
 
@@ -91,6 +91,29 @@ class Utility_Test(unittest.TestCase):
         s5  = SVMTK.union_partially_overlapping_surfaces(s1,s2,50,0.7,1,8)
         self.assertTrue(s5.num_faces()>0) 
 
+    def test_timings(self):
+        SVMTK.clear_timings()
+        SVMTK.enable_timings()
+        surface = SVMTK.Surface()
+        surface.make_cube(0.,0.,0.,1.,1.,1.,0.5)
+        domain = SVMTK.Domain(surface)
+        domain.create_mesh(4.)
+        SVMTK.enable_timings(False)
+        timings = SVMTK.get_timings()
+        self.assertTrue("Domain::make_mesh_3" in timings)
+        self.assertTrue(timings["Domain::create_mesh"]>=timings["Domain::make_mesh_3"])
+        SVMTK.clear_timings()
+        self.assertEqual(len(SVMTK.get_timings()),0)
+
+    def test_make_workload(self):
+        for scene in ["nested_shells","packed_spheres","touching_blocks","tubular_network"]:
+            workload = SVMTK.make_workload(scene,3,2000,1)
+            self.assertEqual(len(workload.surfaces),3)
+            self.assertTrue(workload.number_of_triangles()>1000)
+            self.assertTrue(len(workload.map.get_tags())>1)
+        with self.assertRaises(SVMTK.InvalidArgumentError):
+            SVMTK.make_workload("unknown",3,2000)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -2,6 +2,7 @@
 
 #include "Surface.h"
 #include "Domain.h"
+#include "Parallel.h"
 
 
 
@@ -13,3 +14,50 @@ TEST_CASE("Minimum bounding sphere")
     REQUIRE( domain.get_bounding_sphere_radius()==Approx(3).margin(1e-3)) ; // less than 4 larger than 2 ?
 }
 
+
+TEST_CASE("Partition of a grid graph")
+{
+    const std::size_t n = 20;
+    CSR_graph graph;
+    for(std::size_t i = 0; i < n; ++i)
+       for(std::size_t j = 0; j < n; ++j)
+       {
+          graph.vertex_weights.push_back(1);
+          if( i>0 )   { graph.adjacency.push_back((i-1)*n+j); graph.edge_weights.push_back(1); }
+          if( i<n-1 ) { graph.adjacency.push_back((i+1)*n+j); graph.edge_weights.push_back(1); }
+          if( j>0 )   { graph.adjacency.push_back(i*n+j-1);   graph.edge_weights.push_back(1); }
+          if( j<n-1 ) { graph.adjacency.push_back(i*n+j+1);   graph.edge_weights.push_back(1); }
+          graph.offsets.push_back(graph.adjacency.size());
+       }
+    std::vector<int> parts = partition_graph(graph, 4);
+    std::vector<int> sizes(4, 0);
+    for(int part : parts)
+       sizes[part]++;
+    for(int size : sizes)
+       REQUIRE( size==Approx(100).margin(5) );
+    REQUIRE( edge_cut(graph, parts)<=60 );
+}
+
+
+TEST_CASE("Parallel for each index")
+{
+    std::vector<int> counts(1000, 0);
+    parallel_for(counts.size(), 4, [&](std::size_t i) { counts[i]++; });
+    for(int count : counts)
+       REQUIRE( count==1 );
+
+    std::atomic<int> calls{0};
+    REQUIRE_THROWS_AS( parallel_for(100, 4, [&](std::size_t i)
+    {
+       calls++;
+       if( i%10==0 )
+         throw std::runtime_error("failed");
+    }), std::runtime_error );
+    REQUIRE( calls==100 );
+
+    CancellationToken token;
+    CancellationScope scope(token);
+    std::atomic<int> active{0};
+    parallel_for(8, 4, [&](std::size_t) { active += CancellationToken::current()==&token; });
+    REQUIRE( active==8 );
+}